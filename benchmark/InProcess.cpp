@@ -0,0 +1,189 @@
+/*
+ * In-process benchmark: links the LeekScript library directly and times each
+ * phase (parse, analyze, compile, execute) of every program of the corpus,
+ * without any process startup or JIT initialization in the measures.
+ *
+ * Usage: build/leekscript-benchmark-inprocess [-n iterations] [-w warmup] [-f filter] [-j file.json]
+ * Results are written as JSON to build/benchmark-inprocess.json by default.
+ */
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <dirent.h>
+#include "../src/leekscript.h"
+#include "../src/vm/OutputStream.hpp"
+#include "../src/util/json.hpp"
+
+static const std::vector<std::string> CORPUS = {
+	"benchmark/code",
+	"test/code/euler",
+};
+
+struct Options {
+	int iterations = 10;
+	int warmup = 2;
+	std::string filter = "";
+	std::string json_file = "build/benchmark-inprocess.json";
+};
+
+struct Measures {
+	std::vector<double> parse;
+	std::vector<double> analyze;
+	std::vector<double> compile;
+	std::vector<double> execute;
+	std::vector<double> total;
+};
+
+std::string pad(std::string s, int l) {
+	l -= s.size();
+	while (l-- > 0) s += " ";
+	return s;
+}
+
+/*
+ * List the .leek files of a directory, and of its direct sub-directories
+ * (benchmark/code/<case>/<case>.leek), sorted by path
+ */
+std::vector<std::string> list_programs(const std::string& directory) {
+	std::vector<std::string> files;
+	auto dir = opendir(directory.c_str());
+	if (!dir) return files;
+	while (auto entry = readdir(dir)) {
+		std::string name = entry->d_name;
+		if (name == "." or name == "..") continue;
+		auto path = directory + "/" + name;
+		if (entry->d_type == DT_DIR) {
+			auto sub = list_programs(path);
+			files.insert(files.end(), sub.begin(), sub.end());
+		} else if (name.size() > 5 and name.substr(name.size() - 5) == ".leek") {
+			files.push_back(path);
+		}
+	}
+	closedir(dir);
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+/*
+ * Nearest-rank percentile of sorted values
+ */
+double percentile(const std::vector<double>& sorted, double p) {
+	if (sorted.empty()) return 0;
+	size_t rank = std::max(1, (int) std::ceil(p / 100 * sorted.size()));
+	return sorted[std::min(rank, sorted.size()) - 1];
+}
+
+Json statistics(std::vector<double> values) {
+	std::sort(values.begin(), values.end());
+	double mean = 0;
+	for (auto v : values) mean += v;
+	if (values.size()) mean /= values.size();
+	return {
+		{"min", values.empty() ? 0 : values.front()},
+		{"p10", percentile(values, 10)},
+		{"median", percentile(values, 50)},
+		{"p90", percentile(values, 90)},
+		{"p99", percentile(values, 99)},
+		{"max", values.empty() ? 0 : values.back()},
+		{"mean", mean},
+	};
+}
+
+/*
+ * Run a program once in the given environment, return its result
+ */
+ls::Result run(ls::Environment& env, const std::string& code, const std::string& file) {
+	ls::OutputStringStream output;
+	env.output = &output;
+	ls::Program program { env, code, file };
+	env.analyze(program);
+	env.compile(program);
+	env.execute(program, false, false, false);
+	env.output = ls::VM::default_output;
+	return program.result;
+}
+
+Json benchmark(ls::Environment& env, const std::string& file, const Options& options) {
+
+	auto code = ls::Util::read_file(file);
+	Measures measures;
+	ls::Result result;
+
+	std::cout << pad(file, 40) << std::flush;
+
+	for (int i = 0; i < options.warmup + options.iterations; ++i) {
+		result = run(env, code, file);
+		if (not result.execution_success) break;
+		if (i < options.warmup) continue;
+		measures.parse.push_back(result.parse_time);
+		measures.analyze.push_back(result.analyze_time);
+		measures.compile.push_back(result.compilation_time);
+		measures.execute.push_back(result.execution_time);
+		measures.total.push_back(result.parse_time + result.analyze_time + result.compilation_time + result.execution_time);
+	}
+
+	Json json = {
+		{"file", file},
+		{"success", result.execution_success},
+		{"value", result.value},
+		{"operations", result.operations},
+		{"parse", statistics(measures.parse)},
+		{"analyze", statistics(measures.analyze)},
+		{"compile", statistics(measures.compile)},
+		{"execute", statistics(measures.execute)},
+		{"total", statistics(measures.total)},
+	};
+
+	if (result.execution_success) {
+		std::cout << std::fixed << std::setprecision(2) << std::left;
+		for (const auto& phase : {"parse", "analyze", "compile", "execute"}) {
+			std::cout << std::setw(10) << (double) json[phase]["median"];
+		}
+		std::cout << (double) json["total"]["median"] << " ms (p90 " << (double) json["total"]["p90"] << " ms)" << std::endl;
+	} else {
+		std::cout << "failed" << std::endl;
+	}
+	return json;
+}
+
+int main(int argc, char** argv) {
+
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (i + 1 >= argc) break;
+		if (arg == "-n") options.iterations = std::max(1, std::stoi(argv[++i]));
+		else if (arg == "-w") options.warmup = std::max(0, std::stoi(argv[++i]));
+		else if (arg == "-f") options.filter = argv[++i];
+		else if (arg == "-j") options.json_file = argv[++i];
+	}
+
+	ls::VM::static_init();
+	ls::Environment env;
+
+	std::cout << "In-process benchmark: " << options.warmup << " warm-up + " << options.iterations << " iterations (median times)" << std::endl;
+	std::cout << pad("Program", 40) << pad("parse", 10) << pad("analyze", 10) << pad("compile", 10) << pad("execute", 10) << "total" << std::endl;
+
+	Json programs = Json::array();
+	for (const auto& directory : CORPUS) {
+		for (const auto& file : list_programs(directory)) {
+			if (file.find(options.filter) == std::string::npos) continue;
+			programs.push_back(benchmark(env, file, options));
+		}
+	}
+
+	Json json = {
+		{"iterations", options.iterations},
+		{"warmup", options.warmup},
+		{"programs", programs},
+	};
+	std::ofstream ofs(options.json_file);
+	ofs << json.dump(2) << std::endl;
+	std::cout << "Results written to " << options.json_file << std::endl;
+	return 0;
+}
@@ -1,7 +1,12 @@
 #include "CLI.hpp"
+#include <algorithm>
 #include <chrono>
 #include <unistd.h>
 #include <iostream>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include "analyzer/Context.hpp"
 #include "vm/LSValue.hpp"
 #include "colors.h"
@@ -23,9 +28,15 @@ void CLI::seed_random() {
 	srand(ns);
 }
 
+static double elapsed_ms(std::chrono::high_resolution_clock::time_point start) {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
 void CLI::vm_init() {
 	#if COMPILER
+		auto start = std::chrono::high_resolution_clock::now();
 		VM::static_init();
+		init_time = elapsed_ms(start);
 	#endif
 }
 
@@ -45,8 +56,19 @@ void CLI::setup_options(CLI11::App& app, CLI_options& options, int argc, char* a
     app.add_option("-O", options.optimization, "Optimization level");
     app.add_flag("-r,--execute_ir", options.execute_ir, "Execute as an IR file (.ll or .ir)");
     app.add_flag("-c,--execute_bitcode", options.execute_bitcode, "Execute as an bitcode file (.bc)");
+	app.add_flag("--object", options.object, "Output the code native object file (.o)");
+	app.add_flag("--execute_object", options.execute_object, "Execute as a native object file (.o)");
 	app.add_flag("--documentation", options.documentation, "Generate and output the documentation as JSON");
 	app.add_flag("-s,--sections", options.sections, "Output sections colors");
+	app.add_option("-m,--memory-limit", options.memory_limit, "Memory limit of the execution (MB)");
+	app.add_flag("-p,--profile", options.profile, "Profile the execution (sampling) and output the hot functions");
+	app.add_flag("--counters", options.counters, "Count the boxings, generic calls, clones, reallocations, exceptions and allocated bytes (with -j or -t)");
+	app.add_flag("--cow", options.copy_on_write, "Share the strings between the local variables until they are modified (copy-on-write)");
+	app.add_option("--output-limit", options.output_limit, "Maximum size of the output captured in JSON mode (bytes)");
+	app.add_flag("--stream", options.stream, "In JSON mode, write each printed line at once as a JSON line");
+	app.add_flag("--server", options.server, "Execute the scripts received on stdin, results on stdout (framed: size line, then content)");
+	app.add_option("--socket", options.socket, "Execute the scripts received on a Unix socket, like --server");
+	app.add_option("--max-frame", options.max_frame, "Maximum size of a message of the server (bytes), a larger one is answered by an error");
     try {
         app.parse(argc, argv);
     } catch (const CLI11::ParseError& e) {
@@ -97,6 +119,10 @@ int CLI::start_full(int argc, char* argv[]) {
 		return 0;
 	}
 
+	if (options.server or options.socket.size()) {
+		return server(options);
+	}
+
 	if (app.remaining().size()) {
 		auto file_or_code = app.remaining().at(0);
 		/** Input file or code snippet? */
@@ -133,22 +159,31 @@ int CLI::analyze_file(std::string file, CLI_options options) {
 
 int CLI::execute_snippet(std::string code, CLI_options options) {
 	#if COMPILER
+	auto start = std::chrono::high_resolution_clock::now();
 	ls::Environment env { options.legacy };
+	environment_time = elapsed_ms(start);
 	ls::Program program { env, code, "snippet" };
+	env.profile = options.profile;
+	env.memory_limit = options.memory_limit * 1024 * 1024;
+	env.instrumentation = options.counters;
+	env.copy_on_write = options.copy_on_write;
 
-	OutputStringStream oss;
+	OutputStringStream oss { options.output_limit };
+	OutputJsonLines lines;
 	if (options.json_output) {
-		env.output = &oss;
+		env.output = options.stream ? (OutputStream*) &lines : &oss;
 	}
 	if (not options.execute_ir) {
 		env.analyze(program, options.format, options.debug, options.sections);
 	}
-	env.compile(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimization, options.execute_ir, options.execute_bitcode);
+	env.compile(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimization, options.execute_ir, options.execute_bitcode, options.object);
 	if (not options.execute_ir) {
 		env.execute(program, options.debug, options.operations, false, options.intermediate, options.optimization, options.execute_ir, options.execute_bitcode);
 	}
 
 	print_result(program.result, oss.str(), options.json_output, options.display_time, options.operations);
+	// In JSON, the profile is a field of the result
+	if (options.profile and not options.json_output) std::cout << program.result.profile;
 	#endif
 	return 0;
 }
@@ -157,20 +192,29 @@ int CLI::execute_file(std::string file, CLI_options options) {
 	#if COMPILER
 	auto code = ls::Util::read_file(file);
 	auto file_name = Util::file_short_name(file);
+	auto start = std::chrono::high_resolution_clock::now();
 	ls::Environment env { options.legacy };
-	OutputStringStream oss;
+	environment_time = elapsed_ms(start);
+	OutputStringStream oss { options.output_limit };
+	OutputJsonLines lines;
 	if (options.json_output)
-		env.output = &oss;
+		env.output = options.stream ? (OutputStream*) &lines : &oss;
 	Program program { env, code, file_name };
+	env.profile = options.profile;
+	env.memory_limit = options.memory_limit * 1024 * 1024;
+	env.instrumentation = options.counters;
+	env.copy_on_write = options.copy_on_write;
 
-	if (not options.execute_ir) {
+	if (not options.execute_ir and not options.execute_object) {
 		env.analyze(program, options.format, options.debug, options.sections);
 	}
-	env.compile(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimization, options.execute_ir, options.execute_bitcode);
+	env.compile(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimization, options.execute_ir, options.execute_bitcode, options.object, options.execute_object);
 
 	env.execute(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimization, options.execute_ir, options.execute_bitcode);
 
 	print_result(program.result, oss.str(), options.json_output, options.display_time, options.operations);
+	// In JSON, the profile is a field of the result
+	if (options.profile and not options.json_output) std::cout << program.result.profile;
 	#endif
 	return 0;
 }
@@ -181,6 +225,8 @@ int CLI::repl(CLI_options options) {
 	std::cout << "~~~ LeekScript v2.0 ~~~" << std::endl;
 	std::string code;
 	ls::Environment env { options.legacy };
+	env.instrumentation = options.counters;
+	env.copy_on_write = options.copy_on_write;
 	ls::Context ctx { env };
 
 	while (!std::cin.eof()) {
@@ -200,29 +246,169 @@ int CLI::repl(CLI_options options) {
 	return 0;
 }
 
-void CLI::print_result(ls::Result& result, const std::string& output, bool json, bool display_time, bool ops) {
+/*
+ * Framed protocol of the server: a message is its size in bytes on a line, then its content.
+ * The content of a message larger than the maximum is read and dropped, without allocating it.
+ */
+enum class Frame { OK, END, TOO_LARGE };
+
+static Frame read_frame(int fd, std::string& frame, size_t max_size) {
+	std::string size;
+	char c;
+	while (true) {
+		if (read(fd, &c, 1) != 1) return Frame::END;
+		if (c == '\n') break;
+		if (c < '0' or c > '9' or size.size() > 12) return Frame::END;
+		size += c;
+	}
+	if (size.empty()) return Frame::END;
+	auto length = std::stoul(size);
+	if (length > max_size) {
+		char buffer[4096];
+		while (length > 0) {
+			auto r = read(fd, buffer, std::min(length, sizeof(buffer)));
+			if (r <= 0) return Frame::END;
+			length -= r;
+		}
+		return Frame::TOO_LARGE;
+	}
+	frame.resize(length);
+	size_t position = 0;
+	while (position < frame.size()) {
+		auto r = read(fd, &frame[position], frame.size() - position);
+		if (r <= 0) return Frame::END;
+		position += r;
+	}
+	return Frame::OK;
+}
+
+static bool write_frame(int fd, const std::string& frame) {
+	auto data = std::to_string(frame.size()) + "\n" + frame;
+	size_t position = 0;
+	while (position < data.size()) {
+		auto w = write(fd, data.data() + position, data.size() - position);
+		if (w <= 0) return false;
+		position += w;
+	}
+	return true;
+}
+
+/*
+ * Persistent process: the runtime and the environment are initialized once, then each
+ * script received is executed and its result sent back in JSON (like -j).
+ * Each client takes an environment of the pool, given back with its default options.
+ */
+int CLI::server(CLI_options options) {
+	#if COMPILER
+	auto acquire = [&]() {
+		auto env = Environment::acquire(options.legacy);
+		env->profile = options.profile;
+		env->memory_limit = options.memory_limit * 1024 * 1024;
+		env->instrumentation = options.counters;
+		env->copy_on_write = options.copy_on_write;
+		return env;
+	};
+	signal(SIGPIPE, SIG_IGN); // a client gone is an error of write, not the end of the server
+
+	if (options.socket.empty()) {
+		// The frames go to a copy of stdout, the messages printed by the library (std::cout) to stderr
+		std::cout.flush();
+		auto frames = dup(STDOUT_FILENO);
+		dup2(STDERR_FILENO, STDOUT_FILENO);
+		serve(STDIN_FILENO, frames, *acquire(), options);
+		close(frames);
+		return 0;
+	}
+	sockaddr_un address {};
+	address.sun_family = AF_UNIX;
+	if (options.socket.size() >= sizeof(address.sun_path)) {
+		std::cerr << "Socket path too long: " << options.socket << std::endl;
+		return 1;
+	}
+	strcpy(address.sun_path, options.socket.c_str());
+	unlink(options.socket.c_str());
+	auto server = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server < 0 or bind(server, (sockaddr*) &address, sizeof(address)) < 0 or listen(server, 16) < 0) {
+		std::cerr << "Can't listen on " << options.socket << std::endl;
+		return 1;
+	}
+	// One client at a time: the environment is not shared between threads
+	while (true) {
+		auto client = accept(server, nullptr, nullptr);
+		if (client < 0) break;
+		serve(client, client, *acquire(), options);
+		close(client);
+	}
+	close(server);
+	unlink(options.socket.c_str());
+	#endif
+	return 0;
+}
+
+void CLI::serve(int in, int out, Environment& env, CLI_options& options) {
+	#if COMPILER
+	std::string code;
+	while (true) {
+		auto frame = read_frame(in, code, options.max_frame);
+		if (frame == Frame::END) break;
+		if (frame == Frame::TOO_LARGE) {
+			auto error = "{\"success\":false,\"error\":\"message too large, maximum " + std::to_string(options.max_frame) + " bytes\"}\n";
+			if (not write_frame(out, error)) break;
+			continue;
+		}
+		OutputStringStream output { options.output_limit };
+		env.output = &output;
+		Program program { env, code, "request" };
+		env.analyze(program);
+		env.compile(program, false, false, options.operations);
+		env.execute(program, false, false, options.operations);
+		std::ostringstream result;
+		print_result(program.result, output.str(), true, false, options.operations, result);
+		if (not write_frame(out, result.str())) break;
+	}
+	env.output = nullptr;
+	#endif
+}
+
+void CLI::print_result(ls::Result& result, const std::string& output, bool json, bool display_time, bool ops, std::ostream& os) {
 	if (json) {
 		std::ostringstream oss;
 		print_errors(result, oss, json);
 		std::string res = oss.str() + result.value;
 		res = Util::replace_all(res, "\"", "\\\"");
 		res = Util::replace_all(res, "\n", "");
-		std::cout << "{\"success\":true,\"ops\":" << result.operations
+		os << "{\"success\":true,\"ops\":" << result.operations
+			<< ",\"memory\":" << result.memory_peak
 			<< ",\"time\":" << result.execution_time
 			<< ",\"res\":\"" << res << "\""
-			<< ",\"output\":" << Json(output)
-			<< "}" << std::endl;
+			<< ",\"output\":" << Json(output);
+		if (result.instrumented) {
+			os << ",\"counters\":{\"boxings\":" << result.boxings
+				<< ",\"generic_calls\":" << result.generic_calls
+				<< ",\"clones\":" << result.clones
+				<< ",\"reallocations\":" << result.reallocations
+				<< ",\"exceptions\":" << result.exceptions
+				<< ",\"allocated\":" << result.allocated_bytes << "}";
+		}
+		if (result.profile.size()) {
+			os << ",\"profile\":" << Json(result.profile);
+		}
+		os << "}" << std::endl;
 	} else {
-		print_errors(result, std::cout, json);
+		print_errors(result, os, json);
 		if (result.execution_success && result.value != "(void)") {
-			std::cout << result.value << std::endl;
+			os << result.value << std::endl;
 		}
 		if (display_time) {
-			std::cout << C_GREY << "(";
+			os << C_GREY << "(";
 			if (ops) {
-				std::cout << result.operations << " ops, ";
+				os << result.operations << " ops, ";
+			}
+			os << result.parse_time << "ms + " << result.analyze_time << "ms + " << result.compilation_time << "ms + " << result.execution_time << "ms, " << (result.memory_peak / 1024) << " KB peak)" << END_COLOR << std::endl;
+			os << C_GREY << "(startup: " << init_time << "ms init + " << environment_time << "ms environment)" << END_COLOR << std::endl;
+			if (result.instrumented) {
+				os << C_GREY << "(" << result.boxings << " boxings, " << result.generic_calls << " generic calls, " << result.clones << " clones, " << result.reallocations << " reallocations, " << result.exceptions << " exceptions, " << (result.allocated_bytes / 1024) << " KB allocated)" << END_COLOR << std::endl;
 			}
-			std::cout << result.parse_time << "ms + " << result.compilation_time << "ms + " << result.execution_time << "ms)" << END_COLOR << std::endl;
 		}
 	}
 }
@@ -44,12 +44,26 @@ struct CLI_options {
 	bool example = false;		// E
 	bool execute_ir = false;	// R --execute-ir
 	bool execute_bitcode = false; // W --execute_bitcode
+	bool object = false;		// --object
+	bool execute_object = false; // --execute_object
 	bool sections = false;		// S --sections
+	bool profile = false;		// P --profile
+	long memory_limit = 0;		// M --memory-limit (MB)
+	bool counters = false;		// --counters
+	bool copy_on_write = false;	// --cow
+	size_t output_limit = 0;	// --output-limit (bytes)
+	bool stream = false;		// --stream
+	bool server = false;		// --server
+	std::string socket;			// --socket <path>
+	size_t max_frame = 16 * 1024 * 1024; // --max-frame (bytes)
 };
 
 class CLI {
 public:
 
+	double init_time = 0; // ms, LLVM and VM static initialization
+	double environment_time = 0; // ms, standard library, types and JIT
+
 	void seed_random();
 	void vm_init();
 
@@ -63,9 +77,11 @@ public:
 	int execute_snippet(std::string, CLI_options options);
 	int execute_file(std::string, CLI_options options);
 	int repl(CLI_options);
+	int server(CLI_options);
+	void serve(int in, int out, Environment& env, CLI_options& options);
 
 	void print_errors(ls::Result& result, std::ostream& os, bool json);
-	void print_result(ls::Result& result, const std::string& output, bool json, bool display_time, bool ops);
+	void print_result(ls::Result& result, const std::string& output, bool json, bool display_time, bool ops, std::ostream& os = std::cout);
 };
 
 }
@@ -19,6 +19,8 @@
 #if COMPILER
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
@@ -70,11 +72,15 @@ void Program::analyze(SyntaxicAnalyzer& syn, SemanticAnalyzer& sem, bool format,
 	main->is_main_function = true;
 	main->name = "main";
 
-	sem.analyze(this);
-
 	auto parse_end = std::chrono::high_resolution_clock::now();
 	auto parse_time = std::chrono::duration_cast<std::chrono::nanoseconds>(parse_end - parse_start).count();
 	result.parse_time = (((double) parse_time / 1000) / 1000);
+
+	sem.analyze(this);
+
+	auto analyze_end = std::chrono::high_resolution_clock::now();
+	auto analyze_time = std::chrono::duration_cast<std::chrono::nanoseconds>(analyze_end - parse_end).count();
+	result.analyze_time = (((double) analyze_time / 1000) / 1000);
 	result.analyzed = true;
 
 	type = main->type->return_type();
@@ -109,7 +115,23 @@ Hover Program::hover(SemanticAnalyzer& analyzer, File* file, size_t position) {
 }
 
 #if COMPILER
-void Program::compile_leekscript(Compiler& c, bool format, bool debug, bool bitcode, bool pseudo_code, bool optimized_ir) {
+/*
+ * Type of the result of main, in the object files (the types are not in the native code)
+ */
+enum class MainType { VOID, BOOL, INTEGER, LONG, REAL, MPZ, FUNCTION, ANY };
+
+static MainType main_type(const Type* type) {
+	if (type->is_void()) return MainType::VOID;
+	if (type->is_bool()) return MainType::BOOL;
+	if (type->is_integer()) return MainType::INTEGER;
+	if (type->is_mpz()) return MainType::MPZ;
+	if (type->is_real()) return MainType::REAL;
+	if (type->is_long()) return MainType::LONG;
+	if (type->is_function_pointer()) return MainType::FUNCTION;
+	return MainType::ANY;
+}
+
+void Program::compile_leekscript(Compiler& c, bool format, bool debug, bool bitcode, bool pseudo_code, bool optimized_ir, bool export_object) {
 
 	if (result.errors.size()) {
 		return;
@@ -117,15 +139,35 @@ void Program::compile_leekscript(Compiler& c, bool format, bool debug, bool bitc
 
 	compiler = &c;
 
+	auto compilation_start = std::chrono::high_resolution_clock::now();
+
 	c.vm->internals.clear();
 	c.program = this;
 	c.init();
 	c.vm->context = context;
+	feedback = c.feedback.start(file_name, code);
+	// Big programs: only the functions called pay for the optimization and the code generation.
+	// The parallel compilation goes first while it leaves less than LAZY_FUNCTIONS to each thread:
+	// it compiles everything before the execution, when the lazy mode stops it at each first call.
+	lazy = c.lazy_compilation and functions.size() >= Compiler::LAZY_FUNCTIONS * c.compilation_threads(functions.size()) and not bitcode and not optimized_ir and not export_object;
 
 	module = new llvm::Module(file_name, c.getContext());
 	module->setDataLayout(c.DL);
 
-	main->compile(c);
+	if (export_object) {
+		// The object must not refer to this process: no type feedback counters, no cached versions
+		auto feedback_enabled = c.feedback.enabled;
+		auto versions_enabled = c.versions.enabled;
+		c.feedback.enabled = false;
+		c.versions.enabled = false;
+		main->compile(c);
+		c.feedback.enabled = feedback_enabled;
+		c.versions.enabled = versions_enabled;
+		auto int32 = llvm::Type::getInt32Ty(c.getContext());
+		new llvm::GlobalVariable(*module, int32, true, llvm::GlobalValue::ExternalLinkage, llvm::ConstantInt::get(int32, (int) main_type(main->type->return_type()->fold())), "main.type");
+	} else {
+		main->compile(c);
+	}
 
 	if (pseudo_code) {
 		std::error_code EC2;
@@ -134,11 +176,25 @@ void Program::compile_leekscript(Compiler& c, bool format, bool debug, bool bitc
 		ir.flush();
 	}
 
-	auto compilation_start = std::chrono::high_resolution_clock::now();
+	if (c.vm->profiler.enabled) {
+		// The profiler walks the stack with the frame pointers
+		for (auto& function : *module) {
+			if (function.isDeclaration()) continue;
+			function.addFnAttr("frame-pointer", "all");
+			function.addFnAttr("no-frame-pointer-elim", "true");
+		}
+	}
 
-	module_handle = c.addModule(std::unique_ptr<llvm::Module>(module), true, bitcode, optimized_ir);
+	auto threads = lazy or bitcode or optimized_ir or export_object ? 1 : c.compilation_threads(*module);
+	if (lazy) {
+		module_handle = c.addLazyModule(std::unique_ptr<llvm::Module>(module));
+	} else if (threads > 1) {
+		module_handle = c.addParallelModule(std::unique_ptr<llvm::Module>(module), threads);
+	} else {
+		module_handle = c.addModule(std::unique_ptr<llvm::Module>(module), true, bitcode, optimized_ir, export_object);
+	}
 	handle_created = true;
-	auto ExprSymbol = c.findSymbol("main");
+	auto ExprSymbol = c.findSymbolIn(module_handle, "main");
 	assert(ExprSymbol && "Function not found");
 	closure = (void*) cantFail(ExprSymbol.getAddress());
 	// std::cout << "program type " << main->type->return_type() << std::endl;
@@ -207,13 +263,128 @@ void Program::compile_bitcode_file(Compiler& c) {
 	result.program = type->to_string() + " " + oss.str();
 }
 
-void Program::compile(Compiler& c, bool format, bool debug, bool export_bitcode, bool pseudo_code, bool optimized_ir, bool ir, bool bitcode) {
+/*
+ * The programs are compiled one after the other in the same module, with the same
+ * declarations, then the module is optimized and compiled once. The main function of
+ * each program is renamed, and the module is removed with the last program.
+ */
+void Program::compile_batch(Compiler& c, const std::vector<Program*>& programs) {
+	std::vector<Program*> batch;
+	for (auto program : programs) {
+		if (program->main and program->result.errors.empty()) {
+			batch.push_back(program);
+		}
+	}
+	if (batch.empty()) return;
+
+	auto compilation_start = std::chrono::high_resolution_clock::now();
+
+	auto module = new llvm::Module("batch", c.getContext());
+	module->setDataLayout(c.DL);
+	c.init();
+	for (size_t i = 0; i < batch.size(); ++i) {
+		auto program = batch[i];
+		program->compiler = &c;
+		program->lazy = false;
+		program->module = module;
+		c.vm->internals.clear();
+		c.program = program;
+		c.vm->context = program->context;
+		c.vm->batch_contexts.push_back(program->context);
+		c.batch_index = i;
+		program->feedback = c.feedback.start(program->file_name, program->code);
+		program->main->compile(c);
+		module->getFunction("main")->setName("main." + std::to_string(i));
+	}
+	c.batch_index = -1;
+
+	if (c.vm->profiler.enabled) {
+		for (auto& function : *module) {
+			if (function.isDeclaration()) continue;
+			function.addFnAttr("frame-pointer", "all");
+			function.addFnAttr("no-frame-pointer-elim", "true");
+		}
+	}
+
+	auto threads = c.compilation_threads(*module);
+	auto handle = threads > 1 ? c.addParallelModule(std::unique_ptr<llvm::Module>(module), threads) : c.addModule(std::unique_ptr<llvm::Module>(module), true);
+	auto compiler = &c;
+	auto batch_handle = std::shared_ptr<llvm::orc::VModuleKey>(new llvm::orc::VModuleKey(handle), [compiler](llvm::orc::VModuleKey* handle) {
+		compiler->removeModule(*handle);
+		delete handle;
+	});
+
+	for (size_t i = 0; i < batch.size(); ++i) {
+		auto program = batch[i];
+		program->module_handle = handle;
+		program->batch_handle = batch_handle;
+		auto ExprSymbol = c.findSymbolIn(handle, "main." + std::to_string(i));
+		assert(ExprSymbol && "Function not found");
+		program->closure = (void*) cantFail(ExprSymbol.getAddress());
+		program->type = program->main->type->return_type()->fold();
+	}
+	c.vm->batch_contexts.clear(); // the ctx symbols are resolved with the addresses of the mains
+
+	auto compilation_end = std::chrono::high_resolution_clock::now();
+	auto compilation_time = std::chrono::duration_cast<std::chrono::nanoseconds>(compilation_end - compilation_start).count();
+	for (auto program : batch) {
+		// The time of the batch, shared
+		program->result.compilation_time = (((double) compilation_time / 1000) / 1000) / batch.size();
+		program->result.compilation_success = true;
+	}
+}
+
+/*
+ * Native object compiled by --object: no parsing, analysis, optimization nor code generation,
+ * it's only linked with the runtime symbols of the VM
+ */
+void Program::compile_object_file(Compiler& c) {
+	auto buffer = llvm::MemoryBuffer::getFile(file_name);
+	if (!buffer) {
+		llvm::errs() << buffer.getError().message() << '\n';
+		result.compilation_success = false;
+		result.program = "<error>";
+		return;
+	}
+	auto compilation_start = std::chrono::high_resolution_clock::now();
+	compiler = &c;
+	c.vm->context = context;
+	module_handle = c.addObject(std::move(buffer.get()));
+	handle_created = true;
+	auto type_symbol = c.findSymbolIn(module_handle, "main.type");
+	auto main_symbol = c.findSymbolIn(module_handle, "main");
+	if (!type_symbol or !main_symbol) {
+		llvm::errs() << file_name << ": not a LeekScript object file\n";
+		result.compilation_success = false;
+		result.program = "<error>";
+		return;
+	}
+	closure = (void*) cantFail(main_symbol.getAddress());
+	switch ((MainType) *(int*) cantFail(type_symbol.getAddress())) {
+		case MainType::VOID: type = env.void_; break;
+		case MainType::BOOL: type = env.boolean; break;
+		case MainType::INTEGER: type = env.integer; break;
+		case MainType::LONG: type = env.long_; break;
+		case MainType::REAL: type = env.real; break;
+		case MainType::MPZ: type = env.mpz; break;
+		case MainType::FUNCTION: type = Type::fun(env.void_, {}); break;
+		default: type = env.any;
+	}
+	auto compilation_end = std::chrono::high_resolution_clock::now();
+	auto compilation_time = std::chrono::duration_cast<std::chrono::nanoseconds>(compilation_end - compilation_start).count();
+	result.compilation_time = (((double) compilation_time / 1000) / 1000);
+	result.compilation_success = true;
+}
+
+void Program::compile(Compiler& c, bool format, bool debug, bool export_bitcode, bool pseudo_code, bool optimized_ir, bool ir, bool bitcode, bool export_object, bool object) {
 	if (ir) {
 		compile_ir_file(c);
 	} else if (bitcode) {
 		compile_bitcode_file(c);
+	} else if (object) {
+		compile_object_file(c);
 	} else {
-		compile_leekscript(c, format, debug, export_bitcode, pseudo_code, optimized_ir);
+		compile_leekscript(c, format, debug, export_bitcode, pseudo_code, optimized_ir, export_object);
 	}
 }
 #endif
@@ -278,7 +449,9 @@ std::string Program::execute(VM& vm) {
 		char buff[1000000];
 		mpz_get_str(buff, 10, &ret);
 		mpz_clear(&ret);
-		vm.mpz_deleted++;
+		#if DEBUG_LEAKS
+			vm.mpz_deleted++;
+		#endif
 		return std::string(buff);
 	}
 	if (type->is_real()) {
@@ -41,8 +41,11 @@ public:
 	#if COMPILER
 	Compiler* compiler; // Keep compiler pointer to free module handle
 	bool handle_created = false;
+	bool lazy = false; // functions compiled on their first call
 	llvm::Module* module = nullptr;
 	llvm::orc::VModuleKey module_handle;
+	std::shared_ptr<llvm::orc::VModuleKey> batch_handle; // module shared by the programs of a batch
+	std::shared_ptr<TypeFeedback::Profile> feedback; // counters used by the compiled code
 	#endif
 
 	Program(Environment& env, const std::string& code, const std::string& file_name);
@@ -57,10 +60,12 @@ public:
 	 * Compile the program with a VM and a context (json)
 	 */
 	#if COMPILER
-	void compile(Compiler& c, bool format = false, bool debug = false, bool assembly = false, bool pseudo_code = false, bool optimized_ir = false, bool ir = false, bool bitcode = false);
-	void compile_leekscript(Compiler& c, bool format, bool debug, bool assembly, bool pseudo_code, bool optimized_ir);
+	void compile(Compiler& c, bool format = false, bool debug = false, bool assembly = false, bool pseudo_code = false, bool optimized_ir = false, bool ir = false, bool bitcode = false, bool export_object = false, bool object = false);
+	void compile_leekscript(Compiler& c, bool format, bool debug, bool assembly, bool pseudo_code, bool optimized_ir, bool export_object = false);
 	void compile_ir_file(Compiler& c);
 	void compile_bitcode_file(Compiler& c);
+	void compile_object_file(Compiler& c);
+	static void compile_batch(Compiler& c, const std::vector<Program*>& programs);
 	#endif
 
 	Variable* get_operator(const std::string& name);
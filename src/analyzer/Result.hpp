@@ -17,15 +17,26 @@ struct Result {
 	std::string program = "";
 	std::string value = "";
 	double parse_time = 0;
+	double analyze_time = 0;
 	double compilation_time = 0;
 	double execution_time = 0;
 	long operations = 0;
+	long memory_peak = 0;
 	int objects_created = 0;
 	int objects_deleted = 0;
 	int mpz_objects_created = 0;
 	int mpz_objects_deleted = 0;
+	// Instrumentation counters (Environment::instrumentation)
+	bool instrumented = false;
+	long boxings = 0;
+	long generic_calls = 0;
+	long clones = 0;
+	long reallocations = 0;
+	long exceptions = 0;
+	long allocated_bytes = 0;
 	std::string assembly;
 	std::string pseudo_code;
+	std::string profile;
 	const Type* type = nullptr;
 	#if COMPILER
 	vm::ExceptionObj exception;
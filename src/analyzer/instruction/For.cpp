@@ -4,6 +4,16 @@
 #include "../semantic/Variable.hpp"
 #include "../value/Value.hpp"
 #include "../value/Phi.hpp"
+#include "../value/Expression.hpp"
+#include "../value/FunctionCall.hpp"
+#include "../value/ObjectAccess.hpp"
+#include "../value/VariableValue.hpp"
+#include "../value/ArrayAccess.hpp"
+#include "../value/Number.hpp"
+#include "../value/PostfixExpression.hpp"
+#include "../value/PrefixExpression.hpp"
+#include "ExpressionInstruction.hpp"
+#include "VariableDeclaration.hpp"
 #include "../../colors.h"
 
 namespace ls {
@@ -114,6 +124,9 @@ void For::analyze(SemanticAnalyzer* analyzer, const Type* req_type) {
 
 	analyzer->enter_block(init.get());
 	throws = false;
+	range_index = nullptr;
+	range_array = nullptr;
+	range_accesses.clear();
 
 	// Init
 	for (const auto& section : init->sections) {
@@ -142,6 +155,7 @@ void For::analyze(SemanticAnalyzer* analyzer, const Type* req_type) {
 		condition->sections.front()->instructions.front()->analyze(analyzer);
 		condition->sections.front()->analyze_end(analyzer);
 		throws |= condition->sections.front()->instructions[0]->throws;
+		analyze_range();
 	}
 
 	// Body
@@ -210,9 +224,97 @@ void For::analyze(SemanticAnalyzer* analyzer, const Type* req_type) {
 			}
 		}
 	}
+	if (range_index) {
+		for (const auto& access : range_accesses) {
+			access->in_bounds = true;
+		}
+	}
 	analyzer->leave_block();
 }
 
+/*
+ * Value of a block made of a single expression
+ */
+static Value* single_value(const Block* block) {
+	if (block->sections.size() != 1 or block->sections.front()->instructions.size() != 1) return nullptr;
+	auto instruction = dynamic_cast<ExpressionInstruction*>(block->sections.front()->instructions.front());
+	if (not instruction) return nullptr;
+	auto value = instruction->value.get();
+	while (auto ex = dynamic_cast<Expression*>(value)) {
+		if (ex->op) break;
+		value = ex->v1.get();
+	}
+	return value;
+}
+
+/*
+ * Recognize `for (var i = <integer ≥ 0>; i < a.size(); i++)` (or `++i`, `i += 1`) where `a` is an array variable:
+ * inside the body, 0 <= i < a.size() as long as the body doesn't resize `a` nor modify `i`
+ */
+void For::analyze_range() {
+	auto ex = dynamic_cast<Expression*>(single_value(condition.get()));
+	if (not ex or not ex->op or ex->op->type != TokenType::LOWER) return;
+	auto index = dynamic_cast<VariableValue*>(ex->v1.get());
+	if (not index or not index->var or index->scope != VarScope::LOCAL or not index->type->is_integer()) return;
+	auto size = dynamic_cast<FunctionCall*>(ex->v2.get());
+	if (not size or size->arguments.size()) return;
+	auto oa = dynamic_cast<ObjectAccess*>(size->function.get());
+	if (not oa or oa->field->content != "size") return;
+	auto array = dynamic_cast<VariableValue*>(oa->object.get());
+	if (not array or not array->var or not array->type->is_array()) return;
+	if (array->scope != VarScope::LOCAL and array->scope != VarScope::PARAMETER) return;
+	auto index_root = index->var->get_root();
+
+	// Init : the index starts at a non-negative integer
+	bool init_valid = false;
+	for (const auto& instruction : init->sections.front()->instructions) {
+		auto declaration = dynamic_cast<VariableDeclaration*>(instruction);
+		if (not declaration) continue;
+		for (size_t i = 0; i < declaration->variables.size(); ++i) {
+			auto v = declaration->vars.find(declaration->variables[i]->content);
+			if (v == declaration->vars.end() or v->second != index_root or i >= declaration->expressions.size()) continue;
+			auto start = dynamic_cast<Number*>(declaration->expressions[i].get());
+			init_valid = start and start->type->is_integer() and start->int_value >= 0;
+		}
+	}
+	if (not init_valid) return;
+
+	// Increment : by one
+	auto increment_value = single_value(increment.get());
+	VariableValue* incremented = nullptr;
+	if (auto postfix = dynamic_cast<PostfixExpression*>(increment_value)) {
+		if (postfix->operatorr->type == TokenType::PLUS_PLUS) incremented = dynamic_cast<VariableValue*>(postfix->expression.get());
+	} else if (auto prefix = dynamic_cast<PrefixExpression*>(increment_value)) {
+		if (prefix->operatorr->type == TokenType::PLUS_PLUS) incremented = dynamic_cast<VariableValue*>(prefix->expression.get());
+	} else if (auto add = dynamic_cast<Expression*>(increment_value)) {
+		auto one = dynamic_cast<Number*>(add->v2.get());
+		if (add->op->type == TokenType::PLUS_EQUAL and one and one->type->is_integer() and one->int_value == 1) {
+			incremented = dynamic_cast<VariableValue*>(add->v1.get());
+		}
+	}
+	if (not incremented or not incremented->var or incremented->var->get_root() != index_root) return;
+
+	range_index = index_root;
+	range_array = array->var->get_root();
+}
+
+/*
+ * The body may modify the variable (or resize any array if null)
+ */
+void For::invalidate_range(Variable* variable) {
+	if (not range_index) return;
+	if (variable == nullptr or variable->get_root() == range_index or variable->get_root() == range_array) {
+		range_index = nullptr;
+		range_array = nullptr;
+	}
+}
+
+void For::add_range_access(ArrayAccess* access, Variable* array, Variable* index) {
+	if (range_index and array->get_root() == range_array and index->get_root() == range_index) {
+		range_accesses.push_back(access);
+	}
+}
+
 Hover For::hover(SemanticAnalyzer& analyzer, size_t position) const {
 	if (init->location().contains(position)) {
 		return init->hover(analyzer, position);
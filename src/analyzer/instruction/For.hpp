@@ -11,6 +11,7 @@ namespace ls {
 
 class Block;
 class Variable;
+class ArrayAccess;
 
 class For : public Instruction {
 public:
@@ -21,6 +22,11 @@ public:
 	std::unique_ptr<Block> increment;
 	std::unique_ptr<Block> body;
 	std::vector<Mutation> mutations;
+	// Range of the index of a `for (var i = 0; i < a.size(); i++)` loop : the accesses a[i]
+	// of the body don't need a bounds check if the body can't resize a nor modify i
+	Variable* range_index = nullptr;
+	Variable* range_array = nullptr;
+	std::vector<ArrayAccess*> range_accesses;
 
 	For(Environment& env);
 
@@ -31,6 +37,10 @@ public:
 	virtual void analyze(SemanticAnalyzer*, const Type* req_type) override;
 	virtual Hover hover(SemanticAnalyzer& analyzer, size_t position) const override;
 
+	void analyze_range();
+	void invalidate_range(Variable* variable);
+	void add_range_access(ArrayAccess* access, Variable* array, Variable* index);
+
 	#if COMPILER
 	virtual Compiler::value compile(Compiler&) const override;
 	#endif
@@ -4,6 +4,7 @@
 #include "../../colors.h"
 #include "../value/Phi.hpp"
 #include "../value/VariableValue.hpp"
+#include "../value/Interval.hpp"
 
 namespace ls {
 
@@ -232,7 +233,17 @@ Compiler::value Foreach::compile(Compiler& c) const {
 	c.enter_block(wrapper_block.get());
 	c.enter_section(wrapper_block->sections.front().get());
 
-	auto container_v = container->compile(c);
+	// Intervals are iterated with a simple counter, and a literal interval is not even created
+	auto interval = dynamic_cast<const Interval*>(container.get());
+	bool counted = container->type->is_interval();
+	Compiler::value container_v { c.env };
+	Compiler::value interval_start { c.env };
+	Compiler::value interval_end { c.env };
+	if (interval) {
+		std::tie(interval_start, interval_end) = interval->compile_bounds(c);
+	} else {
+		container_v = container->compile(c);
+	}
 	if (mode == ForeachMode::COPY) {
 		value_var->create_entry(c);
 		if (key_var) key_var->create_entry(c);
@@ -249,10 +260,21 @@ Compiler::value Foreach::compile(Compiler& c) const {
 		c.add_temporary_value(output_v); // Why create variable? in case of `break 2` the output must be deleted
 	}
 
-	c.insn_inc_refs(container_v);
-	c.add_temporary_value(container_v);
-
-	auto it = c.iterator_begin(container_v);
+	Compiler::value it { c.env };
+	if (counted) {
+		if (not interval) {
+			c.insn_inc_refs(container_v);
+			c.add_temporary_value(container_v);
+			interval_start = c.insn_interval_start(container_v);
+			interval_end = c.insn_interval_end(container_v);
+		}
+		it = c.create_entry("i", c.env.integer);
+		c.insn_store(it, interval_start);
+	} else {
+		c.insn_inc_refs(container_v);
+		c.add_temporary_value(container_v);
+		it = c.iterator_begin(container_v);
+	}
 
 	// For arrays, if begin iterator is 0, jump to end directly
 	if (container_v.t->is_array()) {
@@ -268,7 +290,7 @@ Compiler::value Foreach::compile(Compiler& c) const {
 	c.enter_section(condition_section.get());
 
 	// Condition to continue
-	auto finished = c.iterator_end(container_v, it);
+	auto finished = counted ? c.insn_gt(c.insn_load(it), interval_end) : c.iterator_end(container_v, it);
 	c.leave_section_condition(c.insn_not_bool(finished));
 
 	c.enter_loop(nullptr, nullptr);
@@ -278,13 +300,17 @@ Compiler::value Foreach::compile(Compiler& c) const {
 	c.builder.SetInsertPoint(body->sections.front()->basic_block);
 
 	// Get Value
-	if (mode == ForeachMode::ADDRESS) {
+	if (counted) {
+		value_var->val = c.insn_load(it);
+	} else if (mode == ForeachMode::ADDRESS) {
 		value_var->entry = c.iterator_get(container_v.t, it);
 	} else if (mode == ForeachMode::VALUE) {
 		value_var->val = c.iterator_get(container_v.t, it);
 	}
 	// Get Key
-	if (key) {
+	if (key and counted) {
+		key_var->val = c.insn_sub(c.insn_load(it), interval_start);
+	} else if (key) {
 		// if (mode == ForeachMode::ADDRESS) {
 		// 	key_var->entry = c.iterator_key(container_v, it, {c.env});
 		// } else if (mode == ForeachMode::VALUE) {
@@ -302,12 +328,17 @@ Compiler::value Foreach::compile(Compiler& c) const {
 		}
 	}
 	body->compile_end(c);
+	c.insn_check_memory();
 
 	c.leave_loop();
 
 	// it++
 	c.enter_section(increment_section.get());
-	c.iterator_increment(container_v.t, it);
+	if (counted) {
+		c.insn_store(it, c.insn_add(c.insn_load(it), c.new_integer(1)));
+	} else {
+		c.iterator_increment(container_v.t, it);
+	}
 	c.leave_section();
 
 	c.enter_section(end_section);
@@ -3,6 +3,7 @@
 #include "../error/Error.hpp"
 #include "../value/Function.hpp"
 #include "../value/Nulll.hpp"
+#include "../value/VariableValue.hpp"
 #include "../semantic/Variable.hpp"
 
 namespace ls {
@@ -158,7 +159,13 @@ Compiler::value VariableDeclaration::compile(Compiler& c) const {
 			}
 			auto val = ex->compile(c);
 			if (!val.t->reference) {
-				val = c.insn_move_inc(val);
+				// var a = b between two local strings: shared until one of them is modified
+				auto vv = dynamic_cast<VariableValue*>(ex.get());
+				if (c.copy_on_write and vv and vv->var and vv->var->shareable() and variable->shareable()) {
+					val = c.insn_share(val);
+				} else {
+					val = c.insn_move_inc(val);
+				}
 			}
 			variable->create_entry(c);
 			variable->store_value(c, val);
@@ -1,4 +1,5 @@
 #include "FunctionVersion.hpp"
+#include <sstream>
 #include "../../type/Type.hpp"
 #include "../value/Function.hpp"
 #include "../Context.hpp"
@@ -14,6 +15,7 @@
 #if COMPILER
 #include "../../vm/VM.hpp"
 #include "../../compiler/Compiler.hpp"
+#include "llvm/Transforms/Utils/ModuleUtils.h"
 #endif
 
 namespace ls {
@@ -153,6 +155,7 @@ void FunctionVersion::analyze(SemanticAnalyzer* analyzer, const std::vector<cons
 	}
 
 	body->analyze(analyzer);
+	if (body->throws) pure = false;
 
 	auto return_type = env.void_;
 	// std::cout << "body->type " << body->type << std::endl;
@@ -208,6 +211,7 @@ void FunctionVersion::analyze(SemanticAnalyzer* analyzer, const std::vector<cons
 Variable* FunctionVersion::capture(SemanticAnalyzer* analyzer, Variable* var) {
 	// std::cout << "Function::capture " << var << std::endl;
 	auto& env = analyzer->env;
+	var->get_root()->captured = true;
 
 	// the function becomes a closure
 	type = Type::closure(getReturnType(env), type->arguments());
@@ -287,10 +291,10 @@ Hover FunctionVersion::hover(SemanticAnalyzer& analyzer, File* file, size_t posi
 bool FunctionVersion::is_compiled() const {
 	return fun.v != nullptr;
 }
-void FunctionVersion::create_function(Compiler& c) {
-	if (fun.v) return;
-	auto& env = c.env;
-
+/*
+ * Type of the compiled function: the closure is the first argument
+ */
+const Type* FunctionVersion::function_type(Environment& env) const {
 	std::vector<const Type*> args;
 	if (parent->captures.size()) {
 		args.push_back(env.any); // first arg is the function pointer
@@ -298,11 +302,47 @@ void FunctionVersion::create_function(Compiler& c) {
 	for (auto& t : this->type->arguments()) {
 		args.push_back(t);
 	}
-	auto function_type = Type::fun(type->return_type(), args);
-	auto fun_name = parent->is_main_function ? "main" : parent->name;
-	auto f = llvm::Function::Create((llvm::FunctionType*) function_type->llvm(c), llvm::Function::InternalLinkage, fun_name, c.program->module);
+	return Type::fun(type->return_type(), args);
+}
+
+/*
+ * Key of the version in the version cache, empty if the version depends on the program
+ */
+std::string FunctionVersion::cache_key(Compiler& c) const {
+	if (not self_contained or parent->is_main_function or parent->captures.size() or not parent->token) {
+		return "";
+	}
+	auto location = parent->location();
+	const auto& code = location.file->code;
+	auto start = std::min(location.start.raw, code.size());
+	auto source = code.substr(start, std::min(location.end.raw + 1, code.size()) - start);
+	std::ostringstream key;
+	key << location.file->path << ":" << location.start.line << ":" << location.start.column << ":" << std::hash<std::string>{}(source)
+		<< ":" << parent->name << ":" << type << ":" << c.vm->enable_operations << ":" << c.vm->operation_limit << ":" << c.env.legacy << ":" << c.instrumentation << ":" << c.memory_limit << ":" << c.copy_on_write;
+	return key.str();
+}
+
+void FunctionVersion::create_function(Compiler& c, const std::string& symbol) {
+	if (fun.v) return;
+	auto& env = c.env;
+
+	auto function_type = this->function_type(env);
+	auto fun_name = parent->is_main_function ? "main" : (symbol.size() ? symbol : parent->name);
+	// A cached version is linked by name from the modules of the next programs
+	auto linkage = symbol.size() ? llvm::Function::ExternalLinkage : llvm::Function::InternalLinkage;
+	auto f = llvm::Function::Create((llvm::FunctionType*) function_type->llvm(c), linkage, fun_name, c.program->module);
 	fun = { f, function_type->pointer() };
 	assert(c.check_value(fun));
+	if (parent->is_main_function and not c.program->lazy) {
+		// Looked up by the JIT: keep it when the inliner removes the unused internal functions
+		llvm::appendToUsed(*c.program->module, { f });
+	}
+
+	if (c.vm->profiler.enabled) {
+		auto location = parent->location();
+		auto name = parent->name.size() ? parent->name : "<anonymous>";
+		c.vm->profiler.describe(f->getName().str(), name + " (" + location.file->path + ":" + std::to_string(location.start.line) + ")");
+	}
 
 	if (body->throws) {
 		auto personalityfn = c.program->module->getFunction("__gxx_personality_v0");
@@ -323,83 +363,24 @@ Compiler::value FunctionVersion::compile(Compiler& c, bool compile_body) {
 	// std::cout << std::endl;
 
 	if (not is_compiled()) {
-
-		parent->compile_captures(c);
-
-		std::vector<llvm::Type*> args;
-		if (parent->captures.size()) {
-			args.push_back(c.env.any->llvm(c)); // first arg is the function pointer
-		}
-		for (auto& t : this->type->arguments()) {
-			args.push_back(t->llvm(c));
-		}
-		// Create the llvm function
-		create_function(c);
-
-		c.enter_function((llvm::Function*) fun.v, parent->captures.size() > 0, this);
-
-		c.enter_section(body->sections.front().get(), false);
-		// c.builder.SetInsertPoint(block);
-
-		// Declare context vars
-		if (parent->is_main_function and c.vm->context) {
-			for (const auto& var : c.vm->context->vars) {
-				// std::cout << "Main function compile context var " <<  var.first << " " << (void*)var.second.variable << std::endl;
-				c.add_external_var(var.second.variable);
-			}
-		}
-
-		// Create arguments
-		unsigned index = 0;
-		int offset = parent->captures.size() ? -1 : 0;
-		for (auto& arg : ((llvm::Function*) fun.v)->args()) {
-			if (index == 0 && parent->captures.size()) {
-				arg.setName("closure");
-			} else if (offset + index < parent->arguments.size()) {
-				const auto name = parent->arguments.at(offset + index)->content;
-				const auto& argument = initial_arguments.at(name);
-				// std::cout << "create entry of argument " << argument << " " << (void*)argument << std::endl;
-				const auto type = this->type->arguments().at(offset + index)->not_temporary();
-				arg.setName(name);
-				argument->create_entry(c);
-				if (type->is_mpz_ptr()) {
-					c.insn_store(argument->entry, c.insn_load({&arg, type}));
-				} else {
-					if (this->type->arguments().at(offset + index)->temporary) {
-						Compiler::value a = {&arg, type};
-						c.insn_inc_refs(a);
-						c.insn_store(argument->entry, a);
-					} else {
-						c.insn_store(argument->entry, {&arg, type});
-					}
-				}
-			}
-			index++;
-		}
-
-		// Create captures variables
-		for (const auto& capture : captures_inside) {
-			// capture->create_entry(c);
-			// capture->store_value(c, c.insn_get_capture(capture->index, c.env.any));
-			capture->entry = c.insn_get_capture_l(capture->index, c.env.any);
-			// std::cout << "create capture " << capture << " " << (void*) capture << " from get_capture_l " << (void*) capture->entry.v << std::endl;
-		}
-
-		c.leave_section(false);
-
-		if (compile_body) {
-			body->compile(c);
-			body->compile_end(c);
+		auto key = compile_body ? cache_key(c) : "";
+		if (key.size()) {
+			cache_symbol = c.versions.get(c, key, parent->name, [&](const std::string& symbol) {
+				cache_symbol = symbol;
+				compile_function(c, true, symbol);
+			});
 		} else {
-			compile_return(c, { c.env });
+			compile_function(c, compile_body);
 		}
-
 		if (!parent->is_main_function) {
-			c.leave_function();
 			// Create a function : 1 op
 			c.inc_ops(1);
 		}
-		llvm::verifyFunction(*((llvm::Function*) fun.v));
+	}
+	if (cache_symbol.size()) {
+		// A cached version is declared in each module using it
+		auto function_type = this->function_type(c.env);
+		fun = { c.versions.declare(c, cache_symbol, (llvm::FunctionType*) function_type->llvm(c)), function_type->pointer() };
 	}
 
 	if (parent->captures.size()) {
@@ -436,6 +417,84 @@ Compiler::value FunctionVersion::compile(Compiler& c, bool compile_body) {
 	return value;
 }
 
+void FunctionVersion::compile_function(Compiler& c, bool compile_body, const std::string& symbol) {
+
+	parent->compile_captures(c);
+
+	std::vector<llvm::Type*> args;
+	if (parent->captures.size()) {
+		args.push_back(c.env.any->llvm(c)); // first arg is the function pointer
+	}
+	for (auto& t : this->type->arguments()) {
+		args.push_back(t->llvm(c));
+	}
+	// Create the llvm function
+	create_function(c, symbol);
+
+	c.enter_function((llvm::Function*) fun.v, parent->captures.size() > 0, this);
+
+	c.enter_section(body->sections.front().get(), false);
+	// c.builder.SetInsertPoint(block);
+
+	// Declare context vars
+	if (parent->is_main_function and c.vm->context) {
+		for (const auto& var : c.vm->context->vars) {
+			// std::cout << "Main function compile context var " <<  var.first << " " << (void*)var.second.variable << std::endl;
+			c.add_external_var(var.second.variable);
+		}
+	}
+
+	// Create arguments
+	unsigned index = 0;
+	int offset = parent->captures.size() ? -1 : 0;
+	for (auto& arg : ((llvm::Function*) fun.v)->args()) {
+		if (index == 0 && parent->captures.size()) {
+			arg.setName("closure");
+		} else if (offset + index < parent->arguments.size()) {
+			const auto name = parent->arguments.at(offset + index)->content;
+			const auto& argument = initial_arguments.at(name);
+			// std::cout << "create entry of argument " << argument << " " << (void*)argument << std::endl;
+			const auto type = this->type->arguments().at(offset + index)->not_temporary();
+			arg.setName(name);
+			argument->create_entry(c);
+			if (type->is_mpz_ptr()) {
+				c.insn_store(argument->entry, c.insn_load({&arg, type}));
+			} else {
+				if (this->type->arguments().at(offset + index)->temporary) {
+					Compiler::value a = {&arg, type};
+					c.insn_inc_refs(a);
+					c.insn_store(argument->entry, a);
+				} else {
+					c.insn_store(argument->entry, {&arg, type});
+				}
+			}
+		}
+		index++;
+	}
+
+	// Create captures variables
+	for (const auto& capture : captures_inside) {
+		// capture->create_entry(c);
+		// capture->store_value(c, c.insn_get_capture(capture->index, c.env.any));
+		capture->entry = c.insn_get_capture_l(capture->index, c.env.any);
+		// std::cout << "create capture " << capture << " " << (void*) capture << " from get_capture_l " << (void*) capture->entry.v << std::endl;
+	}
+
+	c.leave_section(false);
+
+	if (compile_body) {
+		body->compile(c);
+		body->compile_end(c);
+	} else {
+		compile_return(c, { c.env });
+	}
+
+	if (!parent->is_main_function) {
+		c.leave_function();
+	}
+	llvm::verifyFunction(*((llvm::Function*) fun.v));
+}
+
 void FunctionVersion::compile_return(Compiler& c, Compiler::value v, bool delete_variables) const {
 	assert(c.check_value(v));
 	// Delete temporary mpz arguments
@@ -526,7 +585,7 @@ llvm::BasicBlock* FunctionVersion::get_landing_pad(Compiler& c) {
 		// c.insn_call(c.env.void_, {exception}, "System.delete_exception");
 		// c.insn_call(c.env.void_, {}, "__cxa_rethrow");
 		c.insn_call(c.env.void_, {}, "__cxa_end_catch");
-		c.insn_call(c.env.void_, {new_ex, c.new_long((long) &typeid(vm::ExceptionObj)), c.get_symbol("System.delete_exception", c.env.i8_ptr) }, "__cxa_throw");
+		c.insn_call(c.env.void_, {new_ex, c.exception_type(), c.get_symbol("System.delete_exception", c.env.i8_ptr) }, "__cxa_throw");
 		// c.insn_call(c.env.void_, {}, "llvm.eh.resume");
 		// c.insn_call(c.env.void_, {}, "_Unwind_Resume");
 		// c.builder.CreateResume(landingPadInst);
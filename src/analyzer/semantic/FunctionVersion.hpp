@@ -35,10 +35,13 @@ public:
 	std::unordered_map<std::string, Variable*> arguments;
 	std::vector<Variable*> captures_inside;
 	bool pre_analyzed = false;
+	bool self_contained = true; // only uses its arguments, its variables and the standard library
+	bool pure = true; // no effect visible outside (assignment of a capture, impure call, output, exception)
 	#if COMPILER
 	Compiler::value fun;
 	Compiler::value value;
 	llvm::BasicBlock* block = nullptr;
+	std::string cache_symbol; // compiled in the version cache
 	#endif
 
 	FunctionVersion(Environment& env, std::unique_ptr<Block> body);
@@ -57,8 +60,11 @@ public:
 	Hover hover(SemanticAnalyzer& analyzer, File* file, size_t position);
 
 	#if COMPILER
-	void create_function(Compiler& c);
+	const Type* function_type(Environment& env) const;
+	std::string cache_key(Compiler& c) const;
+	void create_function(Compiler& c, const std::string& symbol = "");
 	Compiler::value compile(Compiler& c, bool compile_body = true);
+	void compile_function(Compiler& c, bool compile_body, const std::string& symbol = "");
 	void compile_return(Compiler& c, Compiler::value v, bool delete_variables = false) const;
 	llvm::BasicBlock* get_landing_pad(Compiler& c);
 	#endif
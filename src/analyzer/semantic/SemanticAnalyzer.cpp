@@ -7,6 +7,7 @@
 #include "../instruction/While.hpp"
 #include "../instruction/For.hpp"
 #include "../instruction/Foreach.hpp"
+#include "../value/VariableValue.hpp"
 #include "../../standard/Module.hpp"
 #include <functional>
 #include "Variable.hpp"
@@ -117,6 +118,29 @@ bool SemanticAnalyzer::in_loop(int deepness) const {
 	return loops.back().size() >= deepness;
 }
 
+void SemanticAnalyzer::invalidate_loop_ranges(Variable* variable) {
+	for (const auto& loop : loops.back()) {
+		if (auto f = dynamic_cast<For*>(loop)) {
+			f->invalidate_range(variable);
+		}
+	}
+}
+
+void SemanticAnalyzer::add_loop_range_access(ArrayAccess* access, Variable* array, Variable* index) {
+	for (const auto& loop : loops.back()) {
+		if (auto f = dynamic_cast<For*>(loop)) {
+			f->add_range_access(access, array, index);
+		}
+	}
+}
+
+void SemanticAnalyzer::modified(Value* value) {
+	auto vv = dynamic_cast<VariableValue*>(value);
+	if (not vv or not vv->var or vv->var->function != current_function()) {
+		current_function()->pure = false;
+	}
+}
+
 Variable* SemanticAnalyzer::get_var(const std::string& v) {
 
 	// std::cout << "SemanticAnalyzer::get_var " << v << std::endl;
@@ -25,6 +25,7 @@ class Call;
 class Block;
 class Section;
 class Instruction;
+class ArrayAccess;
 
 class SemanticAnalyzer {
 public:
@@ -57,6 +58,11 @@ public:
 	void enter_loop(Instruction* loop);
 	void leave_loop();
 	bool in_loop(int deepness) const;
+	/** Bounds of the `for` loops indexes (see For::analyze_range) */
+	void invalidate_loop_ranges(Variable* variable = nullptr);
+	void add_loop_range_access(ArrayAccess* access, Variable* array, Variable* index);
+	/** A value assigned or incremented: the current function is not pure unless it's one of its variables */
+	void modified(Value* value);
 
 	Variable* add_var(Token*, const Type*, Value*);
 	Variable* add_var(Token* token, Variable*);
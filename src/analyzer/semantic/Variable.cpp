@@ -20,6 +20,15 @@ Variable* Variable::get_root() const {
 	return root ? root : (Variable*) this;
 }
 
+/*
+ * A local string variable which can share its string with the other ones (copy-on-write):
+ * its references are only its own, not the ones of a closure or of a caller
+ */
+bool Variable::shareable() const {
+	auto r = get_root();
+	return scope == VarScope::LOCAL and not global and not r->captured and not r->loop_variable and type->is_string();
+}
+
 const Type* Variable::get_entry_type(Environment& env) const {
 	if (type->is_mpz_ptr()) {
 		return env.mpz;
@@ -53,6 +53,7 @@ public:
 	bool injected = false;
 	bool global = false;
 	bool loop_variable = false;
+	bool captured = false; // by a closure (on the root)
 	#if COMPILER
 	Compiler::value entry; // Entry containing the value
 	Compiler::value addr_val;
@@ -66,6 +67,7 @@ public:
 	#endif
 
 	Variable* get_root() const;
+	bool shareable() const;
 	const Type* get_entry_type(Environment& env) const;
 
 	#if COMPILER
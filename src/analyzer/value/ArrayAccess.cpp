@@ -5,6 +5,8 @@
 #include "../semantic/Callable.hpp"
 #include "../semantic/CallableVersion.hpp"
 #include "Number.hpp"
+#include "Interval.hpp"
+#include "VariableValue.hpp"
 
 namespace ls {
 
@@ -72,6 +74,7 @@ void ArrayAccess::analyze(SemanticAnalyzer* analyzer) {
 	const auto& env = analyzer->env;
 	// std::cout << "Analyze AA " << this << " : " << req_type << std::endl;
 
+	in_bounds = false;
 	array->analyze(analyzer);
 
 	if (not array->type->can_be_container()) {
@@ -131,6 +134,12 @@ void ArrayAccess::analyze(SemanticAnalyzer* analyzer) {
 		if (array->type->is_string()) {
 			type = env.string;
 		}
+		// a[i] in a `for (var i = 0; i < a.size(); i++)` loop
+		auto array_variable = dynamic_cast<VariableValue*>(array.get());
+		auto key_variable = dynamic_cast<VariableValue*>(key.get());
+		if (array->type->is_array() and key->type->is_integer() and array_variable and array_variable->var and key_variable and key_variable->var) {
+			analyzer->add_loop_range_access(this, array_variable->var, key_variable->var);
+		}
 	} else if (array->type->is_map()) {
 		if (not env.legacy) { // In legacy mode, any type can be used as the key
 			if (!key->type->castable(map_key_type)) {
@@ -210,6 +219,17 @@ Compiler::value ArrayAccess::compile(Compiler& c) const {
 
 	c.mark_offset(open_bracket->location.start.line);
 
+	// Access on an interval literal [a..b][k] : computed from the bounds, no interval created
+	if (key2 == nullptr) {
+		if (auto interval = dynamic_cast<const Interval*>(array.get())) {
+			auto bounds = interval->compile_bounds(c);
+			c.inc_ops(2);
+			auto k = key->compile(c);
+			key->compile_end(c);
+			return c.insn_interval_at(bounds.first, bounds.second, c.to_int(k));
+		}
+	}
+
 	((ArrayAccess*) this)->compiled_array = array->compile(c);
 	if (array->type->temporary) {
 		c.add_temporary_value(compiled_array);
@@ -223,9 +243,8 @@ Compiler::value ArrayAccess::compile(Compiler& c) const {
 		if (array->type->is_interval()) {
 
 			auto k = key->compile(c);
-			auto r = c.insn_invoke(env.integer, {compiled_array, k}, "Interval.at_i_i");
 			key->compile_end(c);
-			return r;
+			return c.insn_interval_at(c.insn_interval_start(compiled_array), c.insn_interval_end(compiled_array), c.to_int(k));
 
 		} else if (array->type->is_map()) {
 
@@ -274,10 +293,12 @@ Compiler::value ArrayAccess::compile(Compiler& c) const {
 			key->compile_end(c);
 
 			// Check index : k < 0 or k >= size
-			auto array_size = c.insn_array_size(compiled_array);
-			c.insn_if(c.insn_or(c.insn_lt(int_key, c.new_integer(0)), c.insn_ge(int_key, array_size)), [&]() {
-				c.insn_throw_object(vm::Exception::ARRAY_OUT_OF_BOUNDS);
-			});
+			if (not in_bounds) {
+				auto array_size = c.insn_array_size(compiled_array);
+				c.insn_if(c.insn_or(c.insn_lt(int_key, c.new_integer(0)), c.insn_ge(int_key, array_size)), [&]() {
+					c.insn_throw_object(vm::Exception::ARRAY_OUT_OF_BOUNDS);
+				});
+			}
 
 			if (array->type->is_string()) {
 				auto e = c.insn_call(env.tmp_string, {compiled_array, int_key}, "String.codePointAt");
@@ -338,11 +359,13 @@ Compiler::value ArrayAccess::compile_l(Compiler& c) const {
 		c.mark_offset(location().start.line);
 		if (array->type->is_array()) {
 
-			auto array_size = c.insn_array_size(compiled_array);
-			c.insn_if(c.insn_or(c.insn_lt(k, c.new_integer(0)), c.insn_ge(k, array_size)), [&]() {
-				c.insn_delete_temporary(compiled_array);
-				c.insn_throw_object(vm::Exception::ARRAY_OUT_OF_BOUNDS);
-			});
+			if (not in_bounds) {
+				auto array_size = c.insn_array_size(compiled_array);
+				c.insn_if(c.insn_or(c.insn_lt(k, c.new_integer(0)), c.insn_ge(k, array_size)), [&]() {
+					c.insn_delete_temporary(compiled_array);
+					c.insn_throw_object(vm::Exception::ARRAY_OUT_OF_BOUNDS);
+				});
+			}
 			return c.insn_array_at(compiled_array, k);
 
 		} else if (array->type->is_map()) {
@@ -151,11 +151,12 @@ void Expression::analyze(SemanticAnalyzer* analyzer) {
 	}
 
 	// A = B, A += B, etc. A must be a l-value
-	if (op->type == TokenType::EQUAL or op->type == TokenType::PLUS_EQUAL
+	bool assignment = op->type == TokenType::EQUAL or op->type == TokenType::PLUS_EQUAL
 		or op->type == TokenType::MINUS_EQUAL or op->type == TokenType::TIMES_EQUAL
 		or op->type == TokenType::DIVIDE_EQUAL or op->type == TokenType::MODULO_EQUAL
 		or op->type == TokenType::BIT_AND_EQUALS or op->type == TokenType::BIT_OR_EQUALS or op->type == TokenType::BIT_XOR_EQUALS
-		or op->type == TokenType::POWER_EQUAL or op->type == TokenType::INT_DIV_EQUAL) {
+		or op->type == TokenType::POWER_EQUAL or op->type == TokenType::INT_DIV_EQUAL;
+	if (assignment) {
 		// Change the type of x for operator =
 		if (op->type == TokenType::EQUAL) {
 			if (v2->type->is_void()) {
@@ -173,6 +174,19 @@ void Expression::analyze(SemanticAnalyzer* analyzer) {
 			return; // don't analyze more
 		}
 	}
+	// The bounds of the enclosing `for` loops don't hold anymore if the index or the array is assigned,
+	// or if an array is modified (a += x pushes to an array, maybe through another variable)
+	if (assignment or op->type == TokenType::SWAP) {
+		auto vv1 = dynamic_cast<VariableValue*>(v1.get());
+		auto vv2 = dynamic_cast<VariableValue*>(v2.get());
+		if (vv1 and vv1->var) analyzer->invalidate_loop_ranges(vv1->var);
+		if (op->type == TokenType::SWAP and vv2 and vv2->var) analyzer->invalidate_loop_ranges(vv2->var);
+		analyzer->modified(v1.get());
+		if (op->type == TokenType::SWAP) analyzer->modified(v2.get());
+		if (op->type != TokenType::EQUAL and op->type != TokenType::SWAP and not v1->type->is_number() and not v1->type->is_string()) {
+			analyzer->invalidate_loop_ranges();
+		}
+	}
 
 	// Merge operations count
 	// (2 + 3) × 4    ->  2 ops for the × directly
@@ -341,6 +355,14 @@ Compiler::value Expression::compile(Compiler& c) const {
 
 	int flags = callable_version.compile_mutators(c, {v1.get(), v2.get()});
 	if (is_void) flags |= Module::NO_RETURN;
+	// a = b between two local strings: shared until one of them is modified
+	if (op->type == TokenType::EQUAL and c.copy_on_write) {
+		auto vv1 = dynamic_cast<VariableValue*>(v1.get());
+		auto vv2 = dynamic_cast<VariableValue*>(v2.get());
+		if (vv1 and vv1->var and vv1->var->shareable() and vv2 and vv2->var and vv2->var->shareable()) {
+			flags |= Module::SHARE;
+		}
+	}
 
 	auto compiled_v1 = [&](){ if (callable_version.template_()->v1_addr) {
 		return ((LeftValue*) v1.get())->compile_l(c);
@@ -187,6 +187,33 @@ void Function::create_version(SemanticAnalyzer* analyzer, const std::vector<cons
 	version->analyze(analyzer, args);
 }
 
+/*
+ * Arguments of the version called with these types. After `max_function_versions`
+ * versions, a call with new types uses (and creates once) the version taking any,
+ * instead of cloning and analyzing the body again for each combination.
+ * Functions and references keep their exact types, and so do the integers : boxed,
+ * a long would lose its precision above 2^53 and an int would not wrap around anymore.
+ */
+std::vector<const Type*> Function::bounded_version(SemanticAnalyzer* analyzer, const std::vector<const Type*>& args) const {
+	auto& env = analyzer->env;
+	if (env.max_function_versions < 0 or (int) versions.size() < env.max_function_versions) return args;
+	auto version = args;
+	for (size_t i = version.size(); i < arguments.size(); ++i) {
+		if (defaultValues.at(i)) {
+			version.push_back(defaultValues.at(i)->type);
+		}
+	}
+	if (versions.find(version) != versions.end()) return args;
+	std::vector<const Type*> generic;
+	for (size_t i = 0; i < args.size(); ++i) {
+		auto t = args[i];
+		if (t->placeholder or t->is_function() or t->is_function_pointer() or (i < references.size() and references[i])) return args;
+		if (not t->is_primitive() and not t->is_polymorphic()) return args;
+		generic.push_back(t->is_integer() or t->is_long() ? t : env.any);
+	}
+	return generic;
+}
+
 const Type* Function::will_take(SemanticAnalyzer* analyzer, const std::vector<const Type*>& args, int level) {
 	// std::cout << "Function " << " ::will_take " << args << " level " << level << std::endl;
 	if (level == 1) {
@@ -56,6 +56,7 @@ public:
 	virtual void must_return_any(SemanticAnalyzer*) override;
 	virtual Call get_callable(SemanticAnalyzer*, int argument_count) const override;
 	void create_version(SemanticAnalyzer* analyzer, const std::vector<const Type*>& args);
+	std::vector<const Type*> bounded_version(SemanticAnalyzer* analyzer, const std::vector<const Type*>& args) const;
 	virtual void analyze(SemanticAnalyzer*) override;
 	virtual Completion autocomplete(SemanticAnalyzer& analyzer, size_t position) const override;
 	virtual Hover hover(SemanticAnalyzer& analyzer, size_t position) const override;
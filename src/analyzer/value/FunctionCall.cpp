@@ -1,4 +1,5 @@
 #include "FunctionCall.hpp"
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include "../../standard/Module.hpp"
@@ -97,6 +98,63 @@ void FunctionCall::pre_analyze(SemanticAnalyzer* analyzer) {
 	}
 }
 
+/*
+ * The call can't modify an array : a native function on numbers, booleans or strings, or `array.size()`
+ */
+bool FunctionCall::is_pure() const {
+	if (not callable_version) return false;
+	auto t = callable_version.template_();
+	bool native = t->symbol;
+	#if COMPILER
+	native |= t->func != nullptr;
+	#endif
+	if (not native or t->user_fun or t->unknown) return false;
+	auto simple = [](const Type* type) {
+		return type->is_number() or type->is_bool() or type->is_string();
+	};
+	if (auto oa = dynamic_cast<const ObjectAccess*>(function.get())) {
+		if (oa->object->type->is_array() and oa->field->content == "size" and arguments.empty()) return true;
+		if (not oa->object->type->is_class() and not simple(oa->object->type)) return false;
+	}
+	for (const auto& argument : arguments) {
+		if (not simple(argument->type)) return false;
+	}
+	return true;
+}
+
+/*
+ * A function literal without effects: running it element by element in a pipeline, instead
+ * of stage by stage, can't be observed (order of the assignments, outputs and exceptions)
+ */
+static bool pure_function(const Value* value) {
+	auto f = dynamic_cast<const Function*>(value);
+	if (not f) return false;
+	if (f->default_version and not f->default_version->pure) return false;
+	for (const auto& version : f->versions) {
+		if (not version.second->pure) return false;
+	}
+	return true;
+}
+
+/*
+ * Stage of a pipeline: an array method taking a pure function literal, whose intermediate
+ * array can be skipped. The sum is only fused when it's numeric (no string concatenation).
+ */
+FunctionCall::Stage FunctionCall::pipeline_stage() const {
+	if (not callable_version or not call.object) return Stage::NONE;
+	const auto& name = callable_version.template_()->name;
+	auto is = [&](const std::string& method) { return name.rfind(method + ".", 0) == 0; };
+	if (arguments.size() == 1 and pure_function(arguments[0].get())) {
+		if (is("Array.map") or is("Interval.map")) return Stage::MAP;
+		if (is("Array.filter")) return Stage::FILTER;
+	}
+	if (arguments.empty() and is("Array.sum")) {
+		auto t = type->fold();
+		if (t->is_integer() or t->is_long() or t->is_real()) return Stage::SUM;
+	}
+	return Stage::NONE;
+}
+
 Call FunctionCall::get_callable(SemanticAnalyzer*, int argument_count) const {
 	std::vector<const Type*> arguments_types;
 	for (const auto& argument : arguments) {
@@ -127,6 +185,14 @@ void FunctionCall::analyze(SemanticAnalyzer* analyzer) {
 	for (const auto& argument : arguments) {
 		arguments_types.push_back(argument->type);
 	}
+	// Past the maximum number of versions of the function, new argument types share its version taking any
+	auto user_function = dynamic_cast<Function*>(function.get());
+	if (auto vv = dynamic_cast<VariableValue*>(function.get())) {
+		if (vv->var and vv->var->value) user_function = dynamic_cast<Function*>(vv->var->value);
+	}
+	if (user_function) {
+		arguments_types = user_function->bounded_version(analyzer, arguments_types);
+	}
 	function->will_take(analyzer, arguments_types, 1);
 	function->set_version(analyzer, arguments_types, 1);
 
@@ -138,6 +204,13 @@ void FunctionCall::analyze(SemanticAnalyzer* analyzer) {
 	call = function->get_callable(analyzer, arguments_types.size());
 	// std::cout << "Function call: " << call << std::endl;
 	callable_version = call.resolve(analyzer, arguments_types);
+	if (not is_pure()) {
+		analyzer->invalidate_loop_ranges();
+	}
+	// The output is an effect too
+	if (not is_pure() or (callable_version and callable_version.template_()->name.rfind("System.", 0) == 0)) {
+		analyzer->current_function()->pure = false;
+	}
 	if (callable_version) {
 		// std::cout << "Version: " << callable_version << std::endl;
 		type = callable_version.type->return_type();
@@ -173,6 +246,10 @@ void FunctionCall::analyze(SemanticAnalyzer* analyzer) {
 				}
 			}
 		}
+		// Chain of higher-order builtins, compiled in a single loop without the intermediate arrays
+		stage = pipeline_stage();
+		auto previous = dynamic_cast<FunctionCall*>(call.object);
+		pipeline = stage != Stage::NONE and previous and (previous->stage == Stage::MAP or previous->stage == Stage::FILTER);
 		return;
 	}
 	// Find the function object
@@ -357,6 +434,10 @@ Compiler::value FunctionCall::compile(Compiler& c) const {
 	assert(callable_version);
 	// std::cout << "callable_version = " << (void*) callable_version.template_() << std::endl;
 
+	if (pipeline) {
+		return compile_pipeline(c);
+	}
+
 	if (call.object) {
 		callable_version.compile_mutators(c, { call.object });
 	} else if (arguments.size()) {
@@ -373,11 +454,18 @@ Compiler::value FunctionCall::compile(Compiler& c) const {
 
 	int offset = call.object ? 1 : 0;
 	auto f = callable_version.type->function();
+	auto t = callable_version.template_();
+	bool builtin = (t->symbol or t->func) and not t->user_fun and not t->unknown;
 
 	for (unsigned i = 0; i < callable_version.type->arguments().size(); ++i) {
 		if (i < arguments.size()) {
 			types.push_back((LSValueType) callable_version.type->argument(i + offset)->id());
 			auto arg = arguments.at(i)->compile(c);
+			// The parameter is another reference of the string of the variable: not shared anymore (copy-on-write)
+			auto vv = dynamic_cast<VariableValue*>(arguments.at(i).get());
+			if (c.copy_on_write and not builtin and vv and vv->var and vv->var->shareable()) {
+				arg = c.insn_call(arg.t, {vv->compile_l(c)}, "String.unshare");
+			}
 			if (arg.t->is_function_pointer()) {
 				args.push_back(c.insn_convert(arg, callable_version.type->argument(i + offset)));
 			} else if (arguments.at(i)->type->is_primitive()) {
@@ -405,6 +493,95 @@ Compiler::value FunctionCall::compile(Compiler& c) const {
 	}
 	return r;
 }
+
+/*
+ * a.filter(f).map(g).sum(): one loop over `a` applying the stages to each element,
+ * only the result of the last stage is built
+ */
+Compiler::value FunctionCall::compile_pipeline(Compiler& c) const {
+	// Stages from the first one (called on the source) to this one
+	std::vector<const FunctionCall*> stages { this };
+	while (auto previous = dynamic_cast<const FunctionCall*>(stages.back()->call.object)) {
+		if (previous->stage != Stage::MAP and previous->stage != Stage::FILTER) break;
+		stages.push_back(previous);
+	}
+	std::reverse(stages.begin(), stages.end());
+
+	auto first = stages.front();
+	first->callable_version.compile_mutators(c, { first->call.object });
+	auto source = first->call.pre_compile_call(c);
+	std::vector<Compiler::value> functions;
+	for (const auto& s : stages) {
+		if (s->arguments.empty()) { // sum
+			functions.push_back({ c.env });
+			continue;
+		}
+		auto f = s->arguments[0]->compile(c);
+		functions.push_back(f.t->is_function_pointer() ? c.insn_convert(f, s->callable_version.type->argument(1)) : f);
+	}
+
+	Compiler::value result { c.env };
+	Compiler::value sum { c.env };
+	if (stage == Stage::SUM) {
+		auto sum_type = type->fold()->not_temporary();
+		sum = c.create_entry("sum", sum_type);
+		c.insn_store(sum, c.insn_convert(c.new_integer(0), sum_type));
+	} else if (not is_void and (stage == Stage::MAP or stage == Stage::FILTER)) {
+		result = c.new_array(type->element(), {});
+	}
+
+	// Apply the stage i to the element x, `owned` if it's the result of a previous map
+	std::function<void(size_t, Compiler::value, bool)> apply = [&](size_t i, Compiler::value x, bool owned) {
+		auto s = stages[i]->stage;
+		if (s == Stage::FILTER) {
+			auto r = c.insn_call(functions[i], {x});
+			c.insn_if(r, [&]() {
+				if (i + 1 < stages.size()) {
+					apply(i + 1, x, owned);
+				} else if (result.v) {
+					c.insn_push_array(result, owned ? x : c.clone(x));
+				}
+			});
+		} else if (s == Stage::MAP) {
+			auto y = c.clone(x);
+			c.insn_inc_refs(y);
+			auto r = c.insn_call(functions[i], {y});
+			if (r.t->is_void()) {
+				r = c.new_null();
+			}
+			if (i + 1 < stages.size()) {
+				// Kept while the next stages use it
+				c.insn_inc_refs(r);
+				c.insn_delete(y);
+				apply(i + 1, r, true);
+				c.insn_delete(r);
+			} else {
+				if (result.v) {
+					c.insn_push_array(result, r);
+				} else if (r.v) {
+					c.insn_delete_temporary(r);
+				}
+				c.insn_delete(y);
+			}
+		} else if (s == Stage::SUM) {
+			c.insn_store(sum, c.insn_add(c.insn_load(sum), c.insn_convert(x, sum.t->pointed())));
+		}
+	};
+	auto v = Variable::new_temporary("v", source.t->element());
+	v.create_entry(c);
+	c.insn_foreach(source, c.env.void_, &v, nullptr, [&](Compiler::value x, Compiler::value) -> Compiler::value {
+		apply(0, x, false);
+		return { c.env };
+	});
+
+	c.inc_ops(stages.size());
+	first->call.object->compile_end(c);
+	for (const auto& s : stages) {
+		if (s->arguments.size()) s->arguments[0]->compile_end(c);
+	}
+	if (stage == Stage::SUM) return c.insn_load(sum);
+	return result;
+}
 #endif
 
 std::unique_ptr<Value> FunctionCall::clone(Block* parent) const {
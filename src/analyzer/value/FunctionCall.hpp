@@ -36,6 +36,9 @@ public:
 	std::unique_ptr<Callable> callable;
 	bool include = false; // Is a include instruction?
 	File* included_file = nullptr; // Included file in case of include
+	enum class Stage { NONE, MAP, FILTER, SUM };
+	Stage stage = Stage::NONE; // Higher-order builtin which can be fused with the previous ones
+	bool pipeline = false; // Last stage of a chain like a.filter(f).map(g).sum(), compiled in a single loop
 
 	FunctionCall(Environment& env, Token* t);
 
@@ -48,11 +51,14 @@ public:
 	void set_version(SemanticAnalyzer*, const std::vector<const Type*>& args, int level) override;
 	virtual const Type* version_type(std::vector<const Type*>) const override;
 	virtual void analyze(SemanticAnalyzer*) override;
+	bool is_pure() const;
+	Stage pipeline_stage() const;
 	virtual Completion autocomplete(SemanticAnalyzer& analyzer, size_t position) const override;
 	virtual Hover hover(SemanticAnalyzer& analyzer, size_t position) const override;
 
 	#if COMPILER
 	virtual Compiler::value compile(Compiler&) const override;
+	Compiler::value compile_pipeline(Compiler&) const;
 	#endif
 
 	virtual std::unique_ptr<Value> clone(Block* parent) const override;
@@ -38,14 +38,22 @@ void Interval::analyze(SemanticAnalyzer* analyzer) {
 
 #if COMPILER
 Compiler::value Interval::compile(Compiler& c) const {
+	auto bounds = compile_bounds(c);
+	return c.insn_call(c.env.tmp_interval, {bounds.first, bounds.second}, "Interval.new");
+}
+
+/*
+ * Compile only the integer bounds, without creating the interval object.
+ * Used by the for-in loops and the accesses on an interval literal.
+ */
+std::pair<Compiler::value, Compiler::value> Interval::compile_bounds(Compiler& c) const {
 	auto a = start->compile(c);
 	auto b = end->compile(c);
 	auto int_a = c.to_int(a);
 	auto int_b = c.to_int(b);
-	auto interval = c.insn_call(c.env.tmp_interval, {int_a, int_b}, "Interval.new");
 	c.insn_delete_temporary(a);
 	c.insn_delete_temporary(b);
-	return interval;
+	return { int_a, int_b };
 }
 #endif
 
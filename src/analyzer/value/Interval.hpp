@@ -26,6 +26,7 @@ public:
 
 	#if COMPILER
 	virtual Compiler::value compile(Compiler&) const override;
+	std::pair<Compiler::value, Compiler::value> compile_bounds(Compiler&) const;
 	#endif
 
 	virtual std::unique_ptr<Value> clone(Block* parent) const override;
@@ -1,5 +1,13 @@
+#include <set>
 #include "Match.hpp"
+#include "Number.hpp"
+#include "String.hpp"
 #include "../semantic/SemanticAnalyzer.hpp"
+#include "../lexical/Token.hpp"
+#include "../../type/Type.hpp"
+#if COMPILER
+#include "../../standard/class/StringSTD.hpp"
+#endif
 
 namespace ls {
 
@@ -124,11 +132,129 @@ Compiler::value Match::construct_branch(Compiler& c, Compiler::value v, size_t i
 	return c.insn_phi(type, value, label_then, new_branch, label_else);
 }
 
+/*
+ * Constant patterns (`12`, `'a'`), that can be dispatched with a switch
+ */
+static const Number* constant_integer(const Match::Pattern& pattern) {
+	if (pattern.interval) return nullptr;
+	auto number = dynamic_cast<const Number*>(pattern.begin.get());
+	return number and number->type->is_integer() ? number : nullptr;
+}
+static const String* constant_string(const Match::Pattern& pattern) {
+	if (pattern.interval) return nullptr;
+	return dynamic_cast<const String*>(pattern.begin.get());
+}
+
+/*
+ * A match on an integer (resp. a string) whose patterns before the default one are all
+ * integer (resp. string) constants is compiled to a switch instead of a chain of comparisons
+ */
+Match::Lowering Match::lowering(const Type* type) const {
+	bool integer = type->is_integer();
+	bool string = type->is_string();
+	if (not integer and not string) return Lowering::BRANCHES;
+	size_t constants = 0;
+	for (const auto& patterns : pattern_list) {
+		for (const auto& pattern : patterns) {
+			if (pattern.is_default()) return constants ? (integer ? Lowering::INTEGER_SWITCH : Lowering::STRING_SWITCH) : Lowering::BRANCHES;
+			if (integer ? !constant_integer(pattern) : !constant_string(pattern)) return Lowering::BRANCHES;
+			constants++;
+		}
+	}
+	if (not constants) return Lowering::BRANCHES;
+	return integer ? Lowering::INTEGER_SWITCH : Lowering::STRING_SWITCH;
+}
+
+/*
+ * Integers: LLVM switch on the value (lowered to a jump table for dense cases).
+ * Strings: switch on the hash of the value, then comparison with the constants of the bucket.
+ */
+Compiler::value Match::construct_switch(Compiler& c, Compiler::value v, bool strings) const {
+	// The arms after the first default one are unreachable
+	size_t arms = 0;
+	bool has_default = false;
+	for (; arms < pattern_list.size() and not has_default; ++arms) {
+		for (const auto& pattern : pattern_list[arms]) {
+			has_default |= pattern.is_default();
+		}
+	}
+	if (has_default) arms--;
+
+	auto label_default = c.insn_init_label("default");
+	auto label_end = c.insn_init_label("end");
+	std::vector<Compiler::label> labels;
+	for (size_t i = 0; i < arms; ++i) {
+		labels.push_back(c.insn_init_label("case"));
+	}
+
+	if (not strings) {
+		auto sw = c.builder.CreateSwitch(v.v, label_default.block, arms);
+		std::set<int> cases;
+		for (size_t i = 0; i < arms; ++i) {
+			for (const auto& pattern : pattern_list[i]) {
+				auto value = constant_integer(pattern)->int_value;
+				// The first arm wins
+				if (cases.insert(value).second) {
+					sw->addCase(c.builder.getInt32(value), labels[i].block);
+				}
+			}
+		}
+	} else {
+		std::map<int, std::vector<std::pair<const Pattern*, size_t>>> buckets;
+		for (size_t i = 0; i < arms; ++i) {
+			for (const auto& pattern : pattern_list[i]) {
+				buckets[StringSTD::switch_hash_constant(constant_string(pattern)->token->content)].push_back({ &pattern, i });
+			}
+		}
+		auto hash = c.insn_call(c.env.integer, {v}, "String.switch_hash");
+		auto sw = c.builder.CreateSwitch(hash.v, label_default.block, buckets.size());
+		for (const auto& bucket : buckets) {
+			auto label_bucket = c.insn_init_label("bucket");
+			sw->addCase(c.builder.getInt32(bucket.first), label_bucket.block);
+			c.insn_label(&label_bucket);
+			for (const auto& entry : bucket.second) {
+				auto label_next = c.insn_init_label("next");
+				c.insn_if_new(entry.first->match(c, v), &labels[entry.second], &label_next);
+				c.insn_label(&label_next);
+			}
+			c.insn_branch(&label_default);
+		}
+	}
+
+	std::vector<std::pair<Compiler::value, llvm::BasicBlock*>> results;
+	for (size_t i = 0; i < arms; ++i) {
+		c.insn_label(&labels[i]);
+		auto value = c.insn_convert(returns[i]->compile(c), type);
+		returns[i]->compile_end(c);
+		results.push_back({ value, c.builder.GetInsertBlock() });
+		c.insn_branch(&label_end);
+	}
+	c.insn_label(&label_default);
+	auto value = has_default ? c.insn_convert(returns[arms]->compile(c), type) : c.insn_convert(c.new_null(), type);
+	results.push_back({ value, c.builder.GetInsertBlock() });
+	c.insn_branch(&label_end);
+
+	c.insn_label(&label_end);
+	for (const auto& result : results) {
+		if (!result.first.v) return result.first; // void arms
+	}
+	auto phi = c.builder.CreatePHI(type->llvm(c), results.size(), "phi");
+	for (const auto& result : results) {
+		phi->addIncoming(result.first.v, result.second);
+	}
+	return { phi, type->fold() };
+}
+
 Compiler::value Match::compile(Compiler& c) const {
 	auto v = value->compile(c);
 	v.t = v.t->not_temporary();
 	c.insn_inc_refs(v);
-	auto res = construct_branch(c, v, 0);
+	Compiler::value res { c.env };
+	switch (lowering(v.t)) {
+		case Lowering::INTEGER_SWITCH: res = construct_switch(c, v, false); break;
+		case Lowering::STRING_SWITCH: res = construct_switch(c, v, true); break;
+		default: res = construct_branch(c, v, 0);
+	}
 	c.insn_delete(v);
 	return res;
 }
@@ -188,6 +314,9 @@ std::unique_ptr<Value> Match::clone(Block* parent) const {
 			match->pattern_list.back().emplace_back(p.clone(parent));
 		}
 	}
+	for (const auto& r : returns) {
+		match->returns.push_back(r->clone(parent));
+	}
 	return match;
 }
 
@@ -28,7 +28,7 @@ public:
 		#endif
 
 		Pattern clone(Block* parent) const {
-			Pattern p { begin->clone(parent), end->clone(parent) };
+			Pattern p { begin ? begin->clone(parent) : nullptr, end ? end->clone(parent) : nullptr };
 			p.interval = interval;
 			return p;
 		}
@@ -47,6 +47,9 @@ public:
 	virtual void analyze(SemanticAnalyzer*) override;
 
 	#if COMPILER
+	enum class Lowering { BRANCHES, INTEGER_SWITCH, STRING_SWITCH };
+	Lowering lowering(const Type* type) const;
+	Compiler::value construct_switch(Compiler& c, Compiler::value v, bool strings) const;
 	Compiler::value construct_branch(Compiler& c, Compiler::value v, size_t i) const;
 	Compiler::value get_pattern_condition(Compiler& c, Compiler::value v, const std::vector<Pattern>&) const;
 	virtual Compiler::value compile(Compiler&) const override;
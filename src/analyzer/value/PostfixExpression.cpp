@@ -1,5 +1,6 @@
 #include "PostfixExpression.hpp"
 #include "LeftValue.hpp"
+#include "VariableValue.hpp"
 #include "../semantic/SemanticAnalyzer.hpp"
 #include "../error/Error.hpp"
 #include "../../type/Type.hpp"
@@ -31,6 +32,10 @@ void PostfixExpression::analyze(SemanticAnalyzer* analyzer) {
 
 	expression->analyze(analyzer);
 	throws = expression->throws;
+	if (auto vv = dynamic_cast<VariableValue*>(expression.get())) {
+		if (vv->var) analyzer->invalidate_loop_ranges(vv->var);
+	}
+	analyzer->modified(expression.get());
 
 	if (expression->type->constant) {
 		analyzer->add_error({Error::Type::CANT_MODIFY_CONSTANT_VALUE, ErrorLevel::ERROR, location(), expression->location(), {expression->to_string()}});
@@ -37,6 +37,12 @@ void PrefixExpression::analyze(SemanticAnalyzer* analyzer) {
 
 	expression->analyze(analyzer);
 	throws = expression->throws;
+	if (operatorr->type == TokenType::PLUS_PLUS or operatorr->type == TokenType::MINUS_MINUS) {
+		if (auto vv = dynamic_cast<VariableValue*>(expression.get())) {
+			if (vv->var) analyzer->invalidate_loop_ranges(vv->var);
+		}
+		analyzer->modified(expression.get());
+	}
 
 	if (operatorr->type == TokenType::TILDE) {
 		if (expression->type->is_function()) {
@@ -132,10 +132,16 @@ void VariableValue::analyze(SemanticAnalyzer* analyzer) {
 				function_object->analyze(analyzer);
 			}
 		}
+		// A variable of another function (except the recursive calls): the version depends on the program
+		auto function = analyzer->current_function();
+		if (var->scope != VarScope::INTERNAL and var->function != function and var->value != function->parent) {
+			function->self_contained = false;
+		}
 		type = var->type;
 		scope = var->scope;
 		// std::cout << "var " << var << " " << (void*) var << " " << var->type << std::endl;
 	} else {
+		analyzer->current_function()->self_contained = false;
 		bool found = false;
 		for (const auto& variable : analyzer->program->globals) {
 			if (variable.second->type->is_class()) {
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
@@ -9,6 +10,7 @@
 #include <string>
 #include <vector>
 #include <bitset>
+#include <thread>
 #include "Compiler.hpp"
 #include "../analyzer/value/Function.hpp"
 #include "../vm/value/LSNull.hpp"
@@ -30,6 +32,10 @@
 #include "../analyzer/semantic/Variable.hpp"
 #include "../analyzer/instruction/Foreach.hpp"
 #include "../analyzer/value/Phi.hpp"
+#include "../vm/VM.hpp"
+#include "llvm/Object/SymbolSize.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 
 namespace ls {
 
@@ -38,37 +44,21 @@ Compiler::value::value(Environment& env) : v(nullptr), t(env.void_) {}
 Compiler::Compiler(Environment& env, VM* vm) : env(env), Ctx(llvm::make_unique<llvm::LLVMContext>()), builder(*Ctx.getContext()), vm(vm),
 	TM(llvm::EngineBuilder().selectTarget()),
 	DL(TM->createDataLayout()),
-	ObjectLayer(ES, [this](llvm::orc::VModuleKey) {
-		return llvm::orc::LegacyRTDyldObjectLinkingLayer::Resources {
-			std::make_shared<llvm::SectionMemoryManager>(),
-			createLegacyLookupResolver(ES, [this](const std::string& Name) -> llvm::JITSymbol {
-				// std::cout << "Resolve symbol " << Name << std::endl;
-				if (auto Sym = CompileLayer.findSymbol(Name, false)) {
-					return Sym;
-				} else if (auto Err = Sym.takeError()) {
-					return std::move(Err);
-				}
-				auto s = this->vm->resolve_symbol(Name);
-				if (s) {
-					return llvm::JITSymbol((llvm::JITTargetAddress) s, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				}
-				if (Name == "vm") return llvm::JITSymbol((llvm::JITTargetAddress) this->vm, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "null") return llvm::JITSymbol((llvm::JITTargetAddress) LSNull::get(), llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "true") return llvm::JITSymbol((llvm::JITTargetAddress) LSBoolean::get(true), llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "false") return llvm::JITSymbol((llvm::JITTargetAddress) LSBoolean::get(false), llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "mpzc") return llvm::JITSymbol((llvm::JITTargetAddress) &this->vm->mpz_created, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "mpzd") return llvm::JITSymbol((llvm::JITTargetAddress) &this->vm->mpz_deleted, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "operations") return llvm::JITSymbol((llvm::JITTargetAddress) &this->vm->operations, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-
-				if (auto SymAddr = llvm::RTDyldMemoryManager::getSymbolAddressInProcess(Name)) {
-					return llvm::JITSymbol(SymAddr, llvm::JITSymbolFlags::Exported);
-				}
-				return nullptr;
-			},
-			[](llvm::Error Err) {
-				llvm::cantFail(std::move(Err), "lookupFlags failed");
-			})
-		};
+	ObjectLayer(ES, [this](llvm::orc::VModuleKey K) {
+		// The partitions of the lazy modules come with their own resolver
+		auto resolver = resolvers.find(K);
+		if (resolver != resolvers.end()) {
+			auto r = std::move(resolver->second);
+			resolvers.erase(resolver);
+			return llvm::orc::LegacyRTDyldObjectLinkingLayer::Resources { std::make_shared<llvm::SectionMemoryManager>(), r };
+		}
+		return llvm::orc::LegacyRTDyldObjectLinkingLayer::Resources { std::make_shared<llvm::SectionMemoryManager>(), create_resolver() };
+	}, [this](llvm::orc::VModuleKey K, const llvm::object::ObjectFile& object, const llvm::RuntimeDyld::LoadedObjectInfo& info) {
+		if (this->vm->profiler.enabled) {
+			register_symbols(K, object, info);
+		}
+	}, nullptr, [this](llvm::orc::VModuleKey K, const llvm::object::ObjectFile&) {
+		this->vm->profiler.remove_symbols(K);
 	}),
 	CompileLayer(ObjectLayer, llvm::orc::SimpleCompiler(*TM)),
 	OptimizeLayer(CompileLayer, [this](std::unique_ptr<llvm::Module> M) {
@@ -85,14 +75,83 @@ Compiler::Compiler(Environment& env, VM* vm) : env(env), Ctx(llvm::make_unique<l
 			m->print(ir, nullptr);
 			ir.flush();
 		}
+		if (this->export_object) {
+			auto object = llvm::orc::SimpleCompiler(*TM)(*m);
+			std::error_code EC3;
+			llvm::raw_fd_ostream file(m->getName().str() + ".o", EC3, llvm::sys::fs::F_None);
+			file << object->getBuffer();
+			file.flush();
+		}
 		return m;
-	}) {
+	}),
+	CompileCallbackManager(cantFail(llvm::orc::createLocalCompileCallbackManager(TM->getTargetTriple(), ES, 0))),
+	CODLayer(ES, OptimizeLayer, [this](llvm::orc::VModuleKey) {
+		return create_resolver();
+	}, [this](llvm::orc::VModuleKey K, std::shared_ptr<llvm::orc::SymbolResolver> R) {
+		resolvers[K] = std::move(R);
+	}, [](llvm::Function& F) {
+		// One partition per function
+		return std::set<llvm::Function*>({ &F });
+	}, *CompileCallbackManager, llvm::orc::createLocalIndirectStubsManagerBuilder(TM->getTargetTriple())) {
 		llvm::sys::DynamicLibrary::LoadLibraryPermanently(nullptr);
 	}
 
+/*
+ * Resolve a symbol of a module: other modules of the JIT, VM functions and globals, process
+ */
+llvm::JITSymbol Compiler::resolve(const std::string& Name) {
+	// std::cout << "Resolve symbol " << Name << std::endl;
+	// Modules of the JIT, and stubs of the functions of the lazy modules
+	if (auto Sym = CODLayer.findSymbol(Name, false)) {
+		return Sym;
+	} else if (auto Err = Sym.takeError()) {
+		return std::move(Err);
+	}
+	auto s = this->vm->resolve_symbol(Name);
+	if (s) {
+		return llvm::JITSymbol((llvm::JITTargetAddress) s, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+	}
+	if (Name == "vm") return llvm::JITSymbol((llvm::JITTargetAddress) this->vm, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+	if (Name == "null") return llvm::JITSymbol((llvm::JITTargetAddress) LSNull::get(), llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+	if (Name == "true") return llvm::JITSymbol((llvm::JITTargetAddress) LSBoolean::get(true), llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+	if (Name == "false") return llvm::JITSymbol((llvm::JITTargetAddress) LSBoolean::get(false), llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+	if (Name == "mpzc") return llvm::JITSymbol((llvm::JITTargetAddress) &this->vm->mpz_created, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+	if (Name == "mpzd") return llvm::JITSymbol((llvm::JITTargetAddress) &this->vm->mpz_deleted, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+	if (Name == "operations") return llvm::JITSymbol((llvm::JITTargetAddress) &this->vm->operations, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+	if (Name == "exception_type") return llvm::JITSymbol((llvm::JITTargetAddress) &typeid(vm::ExceptionObj), llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+	if (Name == "memory_exceeded") return llvm::JITSymbol((llvm::JITTargetAddress) &this->vm->memory.exceeded, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+	if (Name == "counters") return llvm::JITSymbol((llvm::JITTargetAddress) &this->vm->memory.counters, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+
+	if (auto SymAddr = llvm::RTDyldMemoryManager::getSymbolAddressInProcess(Name)) {
+		return llvm::JITSymbol(SymAddr, llvm::JITSymbolFlags::Exported);
+	}
+	return nullptr;
+}
+
+std::shared_ptr<llvm::orc::SymbolResolver> Compiler::create_resolver() {
+	return llvm::orc::createLegacyLookupResolver(ES, [this](const std::string& Name) {
+		return resolve(Name);
+	}, [](llvm::Error Err) {
+		llvm::cantFail(std::move(Err), "lookupFlags failed");
+	});
+}
+
 std::unique_ptr<llvm::Module> Compiler::optimizeModule(std::unique_ptr<llvm::Module> M) {
+	inline_functions(*M);
+	optimize_functions(*M);
+	return M;
+}
+
+void Compiler::inline_functions(llvm::Module& M) {
+	// Inline the direct calls to the small functions of the program (internal linkage)
+	llvm::legacy::PassManager MPM;
+	MPM.add(llvm::createFunctionInliningPass(INLINE_THRESHOLD));
+	MPM.run(M);
+}
+
+void Compiler::optimize_functions(llvm::Module& M) {
 	// Create a function pass manager.
-	auto FPM = llvm::make_unique<llvm::legacy::FunctionPassManager>(M.get());
+	auto FPM = llvm::make_unique<llvm::legacy::FunctionPassManager>(&M);
 	// Add some optimizations.
 	FPM->add(llvm::createBasicAAWrapperPass());
 	FPM->add(llvm::createInstructionCombiningPass());
@@ -101,19 +160,138 @@ std::unique_ptr<llvm::Module> Compiler::optimizeModule(std::unique_ptr<llvm::Mod
 	FPM->add(llvm::createCFGSimplificationPass());
 	FPM->doInitialization();
 	// Run the optimizations over all functions in the module being added to the JIT.
-	for (auto &F : *M)
+	for (auto &F : M)
 		FPM->run(F);
-	return M;
 }
 
-llvm::orc::VModuleKey Compiler::addModule(std::unique_ptr<llvm::Module> M, bool optimize, bool export_bitcode, bool export_optimized_ir) {
+/*
+ * Give the addresses of the functions of a loaded object to the profiler
+ */
+void Compiler::register_symbols(llvm::orc::VModuleKey K, const llvm::object::ObjectFile& object, const llvm::RuntimeDyld::LoadedObjectInfo& info) {
+	// Copy of the object with the sections at their load addresses
+	auto debug_object = info.getObjectForDebug(object);
+	if (!debug_object.getBinary()) return;
+	for (const auto& symbol_size : llvm::object::computeSymbolSizes(*debug_object.getBinary())) {
+		auto symbol = symbol_size.first;
+		auto type = symbol.getType();
+		if (!type) {
+			llvm::consumeError(type.takeError());
+			continue;
+		}
+		if (*type != llvm::object::SymbolRef::ST_Function) continue;
+		auto name = symbol.getName();
+		if (!name) {
+			llvm::consumeError(name.takeError());
+			continue;
+		}
+		auto address = symbol.getAddress();
+		if (!address) {
+			llvm::consumeError(address.takeError());
+			continue;
+		}
+		vm->profiler.add_symbol(K, *address, symbol_size.second, name->str());
+	}
+}
+
+llvm::orc::VModuleKey Compiler::addModule(std::unique_ptr<llvm::Module> M, bool optimize, bool export_bitcode, bool export_optimized_ir, bool export_object) {
 	auto K = ES.allocateVModule();
 	this->export_bitcode = export_bitcode;
 	this->export_optimized_ir = export_optimized_ir;
+	this->export_object = export_object;
 	cantFail(OptimizeLayer.addModule(K, std::move(M)));
 	return K;
 }
 
+llvm::orc::VModuleKey Compiler::addObject(std::unique_ptr<llvm::MemoryBuffer> object) {
+	auto K = ES.allocateVModule();
+	cantFail(ObjectLayer.addObject(K, std::move(object)));
+	object_modules.insert(K);
+	return K;
+}
+
+llvm::orc::VModuleKey Compiler::addLazyModule(std::unique_ptr<llvm::Module> M) {
+	auto K = ES.allocateVModule();
+	this->export_bitcode = false;
+	this->export_optimized_ir = false;
+	this->export_object = false;
+	cantFail(CODLayer.addModule(K, std::move(M)));
+	lazy_modules.insert(K);
+	return K;
+}
+
+unsigned Compiler::compilation_threads(const llvm::Module& M) const {
+	size_t functions = 0;
+	for (const auto& F : M) {
+		if (!F.isDeclaration()) functions++;
+	}
+	return compilation_threads(functions);
+}
+
+unsigned Compiler::compilation_threads(size_t functions) const {
+	if (not parallel_compilation) return 1;
+	return std::max(1u, std::min(std::thread::hardware_concurrency(), (unsigned) (functions / PARALLEL_FUNCTIONS)));
+}
+
+/*
+ * Inline in the whole module, split it, then optimize and compile each part in its own thread
+ * and context (a LLVMContext is not thread-safe, the parts go through bitcode). The objects are
+ * linked in the session, each part resolves the functions of the other parts first.
+ */
+llvm::orc::VModuleKey Compiler::addParallelModule(std::unique_ptr<llvm::Module> M, unsigned threads) {
+	inline_functions(*M);
+	// The split exports all the functions, main included
+	if (auto used = M->getGlobalVariable("llvm.used")) {
+		used->eraseFromParent();
+	}
+	std::vector<llvm::SmallVector<char, 0>> bitcodes;
+	llvm::SplitModule(std::move(M), threads, [&](std::unique_ptr<llvm::Module> part) {
+		bitcodes.emplace_back();
+		llvm::raw_svector_ostream os(bitcodes.back());
+		llvm::WriteBitcodeToFile(*part, os);
+	});
+
+	std::vector<std::unique_ptr<llvm::TargetMachine>> machines;
+	for (size_t i = 0; i < bitcodes.size(); ++i) {
+		machines.emplace_back(llvm::EngineBuilder().selectTarget());
+	}
+	std::vector<std::unique_ptr<llvm::MemoryBuffer>> objects(bitcodes.size());
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < bitcodes.size(); ++i) {
+		workers.emplace_back([&, i]() {
+			llvm::LLVMContext context;
+			llvm::MemoryBufferRef bitcode { llvm::StringRef(bitcodes[i].data(), bitcodes[i].size()), "part" };
+			auto part = cantFail(llvm::parseBitcodeFile(bitcode, context));
+			optimize_functions(*part);
+			objects[i] = llvm::orc::SimpleCompiler(*machines[i])(*part);
+		});
+	}
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	auto K = ES.allocateVModule();
+	auto& parts = parallel_modules[K];
+	for (size_t i = 0; i < objects.size(); ++i) {
+		parts.push_back(ES.allocateVModule());
+	}
+	for (size_t i = 0; i < objects.size(); ++i) {
+		resolvers[parts[i]] = llvm::orc::createLegacyLookupResolver(ES, [this, K](const std::string& Name) -> llvm::JITSymbol {
+			for (auto part : parallel_modules.at(K)) {
+				if (auto Sym = ObjectLayer.findSymbolIn(part, Name, false)) {
+					return Sym;
+				} else if (auto Err = Sym.takeError()) {
+					return std::move(Err);
+				}
+			}
+			return resolve(Name);
+		}, [](llvm::Error Err) {
+			llvm::cantFail(std::move(Err), "lookupFlags failed");
+		});
+		cantFail(ObjectLayer.addObject(parts[i], std::move(objects[i])));
+	}
+	return K;
+}
+
 llvm::AllocaInst* Compiler::CreateEntryBlockAlloca(const std::string& VarName, llvm::Type* type) const {
 	assert(F);
 	llvm::IRBuilder<> builder(&F->getEntryBlock(), F->getEntryBlock().begin());
@@ -138,6 +316,10 @@ Compiler::value Compiler::clone(Compiler::value v) {
 Compiler::value Compiler::new_null() {
 	return get_symbol("null", env.null);
 }
+Compiler::value Compiler::exception_type() {
+	// A symbol and not a constant: the address is not the same in the process that loads an object file
+	return { builder.CreatePtrToInt(get_symbol("exception_type", env.i8->pointer()).v, env.long_->llvm(*this)), env.long_ };
+}
 Compiler::value Compiler::new_bool(bool b) {
 	return { llvm::ConstantInt::get(getContext(), llvm::APInt(1, b, false)), env.boolean };
 }
@@ -192,7 +374,7 @@ Compiler::value Compiler::new_function(std::string name, const Type* type) {
 Compiler::value Compiler::new_closure(Compiler::value f, std::vector<Compiler::value> captures) {
 	// std::cout << "new_closure " << captures << std::endl;
 	auto fun = insn_convert(f, env.i8_ptr);
-	auto closure = insn_call(Type::closure(f.t->return_type(), f.t->arguments()), {get_vm(), fun}, "Function.new.1");
+	auto closure = insn_call(Type::closure(f.t->return_type(), f.t->arguments()), {get_vm(), fun, new_integer(captures.size())}, "Function.new.1");
 	for (const auto& capture : captures) {
 		function_add_capture(closure, capture);
 	}
@@ -514,6 +696,66 @@ Compiler::value Compiler::insn_or(Compiler::value a, Compiler::value b) {
 	return {builder.CreateOr(a.v, b.v), env.boolean};
 }
 
+/*
+ * Operation on `any` values guided by the type feedback of the site: profiling tier
+ * (count the operand types, generic call), or inline check that the `any` operands are
+ * numbers and unboxed `fast` operation on their reals, with the generic call as fallback.
+ */
+Compiler::value Compiler::insn_speculate(Compiler::value a, Compiler::value b, const Type* type, std::function<Compiler::value(Compiler::value, Compiler::value)> fast, std::function<Compiler::value()> generic) {
+	auto a_type = a.t->fold();
+	auto b_type = b.t->fold();
+	auto numeric = [](const Type* t) { return t->is_integer() or t->is_real() or t->is_long(); };
+	bool any_a = a_type->is_any();
+	bool any_b = b_type->is_any();
+	if (not (any_a or any_b) or not (any_a or numeric(a_type)) or not (any_b or numeric(b_type))) {
+		return generic();
+	}
+	auto site = feedback.next_site();
+	if (!site) return generic();
+	auto tier = feedback.tier(site, any_a, any_b);
+	if (tier == TypeFeedback::Tier::PROFILE) {
+		if (any_a) insn_record_type(a, site->types[0]);
+		if (any_b) insn_record_type(b, site->types[1]);
+		return generic();
+	}
+	if (tier == TypeFeedback::Tier::GENERIC) {
+		return generic();
+	}
+	auto check = new_bool(true);
+	if (any_a) check = insn_and(check, insn_eq(insn_value_type(a), new_integer(LSValue::NUMBER)));
+	if (any_b) check = insn_and(check, insn_eq(insn_value_type(b), new_integer(LSValue::NUMBER)));
+	auto r = create_entry("r", type);
+	insn_if(check, [&]() {
+		auto x = any_a ? insn_number_value(a) : to_real(a);
+		auto y = any_b ? insn_number_value(b) : to_real(b);
+		insn_store(r, fast(x, y));
+	}, [&]() {
+		insn_store(r, generic());
+	});
+	return insn_load(r);
+}
+
+/*
+ * Box the real result of a speculated operation, reusing a temporary operand like LSNumber::add
+ */
+Compiler::value Compiler::insn_number_result(Compiler::value r, Compiler::value a, Compiler::value b) {
+	auto reusable = [](Compiler::value v) { return v.t->fold()->is_any() and v.t->temporary; };
+	if (not reusable(a) and not reusable(b)) {
+		return insn_call(env.tmp_any, {r}, "Number.new.4");
+	}
+	auto tmp = reusable(a) ? a : b;
+	auto other = reusable(a) ? b : a;
+	auto result = create_entry("n", env.any);
+	insn_if(insn_eq(insn_refs(tmp), new_integer(0)), [&]() {
+		builder.CreateStore(r.v, number_address(tmp));
+		insn_store(result, tmp);
+	}, [&]() {
+		insn_store(result, insn_call(env.tmp_any, {r}, "Number.new.4"));
+	});
+	insn_delete_temporary(other);
+	return insn_load(result);
+}
+
 Compiler::value Compiler::insn_add(Compiler::value a, Compiler::value b) {
 	// std::cout << "insn_add(" << a.t << ", " << b.t << ")" << std::endl;
 	assert(check_value(a));
@@ -521,7 +763,11 @@ Compiler::value Compiler::insn_add(Compiler::value a, Compiler::value b) {
 	auto a_type = a.t->fold();
 	auto b_type = b.t->fold();
 	if (a_type->is_polymorphic() or b_type->is_polymorphic()) {
-		return insn_invoke(env.any, {insn_to_any(a), insn_to_any(b)}, "Value.operator+");
+		return insn_speculate(a, b, env.any, [&](Compiler::value x, Compiler::value y) {
+			return insn_number_result({builder.CreateFAdd(x.v, y.v), env.real}, a, b);
+		}, [&]() {
+			return insn_invoke(env.any, {insn_to_any(a), insn_to_any(b)}, "Value.operator+");
+		});
 	} else if (a_type->is_real() or b_type->is_real()) {
 		return {builder.CreateFAdd(to_real(a).v, to_real(b).v), env.real};
 	} else if (a_type->is_long() or b_type->is_long()) {
@@ -537,7 +783,11 @@ Compiler::value Compiler::insn_sub(Compiler::value a, Compiler::value b) {
 	auto a_type = a.t->fold();
 	auto b_type = b.t->fold();
 	if (a_type->is_polymorphic() or b_type->is_polymorphic()) {
-		return insn_invoke(env.any, {insn_to_any(a), insn_to_any(b)}, "Value.operator-");
+		return insn_speculate(a, b, env.any, [&](Compiler::value x, Compiler::value y) {
+			return insn_number_result({builder.CreateFSub(x.v, y.v), env.real}, a, b);
+		}, [&]() {
+			return insn_invoke(env.any, {insn_to_any(a), insn_to_any(b)}, "Value.operator-");
+		});
 	} else if (a_type->is_real() or b_type->is_real()) {
 		return {builder.CreateFSub(to_real(a).v, to_real(b).v), env.real};
 	} else if (a_type->is_long() or b_type->is_long()) {
@@ -554,12 +804,19 @@ Compiler::value Compiler::insn_eq(Compiler::value a, Compiler::value b) {
 	auto a_type = a.t->fold();
 	auto b_type = b.t->fold();
 	if (a_type->is_polymorphic() or b_type->is_polymorphic()) {
-		auto ap = insn_to_any(a);
-		auto bp = insn_to_any(b);
-		auto r = insn_call(env.boolean, {ap, bp}, "Value.operator==");
-		insn_delete_temporary(ap);
-		insn_delete_temporary(bp);
-		return r;
+		return insn_speculate(a, b, env.boolean, [&](Compiler::value x, Compiler::value y) {
+			Compiler::value r = {builder.CreateFCmpOEQ(x.v, y.v), env.boolean};
+			insn_delete_temporary(a);
+			insn_delete_temporary(b);
+			return r;
+		}, [&]() {
+			auto ap = insn_to_any(a);
+			auto bp = insn_to_any(b);
+			auto r = insn_call(env.boolean, {ap, bp}, "Value.operator==");
+			insn_delete_temporary(ap);
+			insn_delete_temporary(bp);
+			return r;
+		});
 	}
 	if (a_type->is_pointer() or b_type->is_pointer()) {
 		if (a_type->is_pointer() and b_type->is_pointer()) {
@@ -567,7 +824,7 @@ Compiler::value Compiler::insn_eq(Compiler::value a, Compiler::value b) {
 		}
 		return new_bool(false);
 	} else if (a_type->is_mpz_ptr() and b_type->is_integer()) {
-		auto r = insn_eq(insn_call(env.boolean, {a, b}, "Number._mpz_cmp_si"), new_integer(0));
+		auto r = insn_eq(insn_mpz_cmp_si(a, b), new_integer(0));
 		insn_delete_temporary(a);
 		return r;
 	} else if (a_type->is_mpz_ptr() and b_type->is_mpz_ptr()) {
@@ -611,20 +868,27 @@ Compiler::value Compiler::insn_lt(Compiler::value a, Compiler::value b) {
 	assert(check_value(a));
 	assert(check_value(b));
 	if (a.t->is_polymorphic() or b.t->is_polymorphic()) {
-		auto ap = insn_to_any(a);
-		auto bp = insn_to_any(b);
-		auto r = insn_call(env.boolean, {ap, bp}, "Value.operator<");
-		insn_delete_temporary(ap);
-		insn_delete_temporary(bp);
-		return r;
+		return insn_speculate(a, b, env.boolean, [&](Compiler::value x, Compiler::value y) {
+			Compiler::value r = {builder.CreateFCmpOLT(x.v, y.v), env.boolean};
+			insn_delete_temporary(a);
+			insn_delete_temporary(b);
+			return r;
+		}, [&]() {
+			auto ap = insn_to_any(a);
+			auto bp = insn_to_any(b);
+			auto r = insn_call(env.boolean, {ap, bp}, "Value.operator<");
+			insn_delete_temporary(ap);
+			insn_delete_temporary(bp);
+			return r;
+		});
 	}
 	Compiler::value r { env };
 	if (a.t->is_integer() and b.t->is_mpz_ptr()) {
-		auto r = insn_gt(insn_call(env.integer, {b, a}, "Number._mpz_cmp_si"), new_integer(0));
+		auto r = insn_gt(insn_mpz_cmp_si(b, a), new_integer(0));
 		insn_delete_temporary(b);
 		return r;
 	} else if (a.t->is_mpz_ptr() and b.t->is_integer()) {
-		auto r = insn_lt(insn_call(env.integer, {a, b}, "Number._mpz_cmp_si"), new_integer(0));
+		auto r = insn_lt(insn_mpz_cmp_si(a, b), new_integer(0));
 		insn_delete_temporary(a);
 		return r;
 	} else if (a.t->is_mpz_ptr() and b.t->is_mpz_ptr()) {
@@ -668,11 +932,11 @@ Compiler::value Compiler::insn_gt(Compiler::value a, Compiler::value b) {
 	assert(check_value(b));
 	Compiler::value r { env };
 	if (a.t->is_mpz_ptr() and b.t->is_integer()) {
-		auto res = insn_call(env.integer, {a, b}, "Number._mpz_cmp_si");
+		auto res = insn_mpz_cmp_si(a, b);
 		insn_delete_temporary(a);
 		return insn_gt(res, new_integer(0));
 	} else if (a.t->is_integer() and b.t->is_mpz_ptr()) {
-		auto res = insn_call(env.integer, {b, a}, "Number._mpz_cmp_si");
+		auto res = insn_mpz_cmp_si(b, a);
 		insn_delete_temporary(b);
 		return insn_lt(res, new_integer(0));
 	} else if (a.t->is_real() || b.t->is_real()) {
@@ -1010,6 +1274,9 @@ Compiler::value Compiler::insn_to_any(Compiler::value v) {
 	if (v.t->is_polymorphic()) {
 		return v; // already any
 	}
+	if (not v.t->is_bool() and not v.t->is_function_pointer()) {
+		insn_count(offsetof(LSValue::Counters, boxings));
+	}
 	if (v.t->is_long()) {
 		return insn_call(env.tmp_any, {to_real(v)}, "Number.new.4");
 	} else if (v.t->is_real()) {
@@ -1121,6 +1388,41 @@ Compiler::value Compiler::insn_typeof(Compiler::value v) {
 	return new_integer(v.t->id());
 }
 
+/*
+ * LSValue::type of an `any` value (the type feedback reads it inline, without the Value.type call)
+ */
+Compiler::value Compiler::insn_value_type(Compiler::value v) {
+	assert(v.t->fold()->is_any());
+	auto int8 = llvm::Type::getInt8Ty(getContext());
+	auto p = builder.CreateConstInBoundsGEP1_64(int8, builder.CreatePointerCast(v.v, int8->getPointerTo()), TypeFeedback::TYPE_OFFSET);
+	return { builder.CreateZExt(builder.CreateLoad(int8, p), llvm::Type::getInt32Ty(getContext())), env.integer };
+}
+
+llvm::Value* Compiler::number_address(Compiler::value v) {
+	auto int8 = llvm::Type::getInt8Ty(getContext());
+	auto p = builder.CreateConstInBoundsGEP1_64(int8, builder.CreatePointerCast(v.v, int8->getPointerTo()), TypeFeedback::NUMBER_OFFSET);
+	return builder.CreatePointerCast(p, llvm::Type::getDoublePtrTy(getContext()));
+}
+
+/*
+ * LSNumber::value of an `any` value known to be a number
+ */
+Compiler::value Compiler::insn_number_value(Compiler::value v) {
+	assert(v.t->fold()->is_any());
+	return { builder.CreateLoad(llvm::Type::getDoubleTy(getContext()), number_address(v)), env.real };
+}
+
+/*
+ * counters[type of v]++ (profiling tier of the type feedback)
+ */
+void Compiler::insn_record_type(Compiler::value v, int64_t* counters) {
+	auto int64 = llvm::Type::getInt64Ty(getContext());
+	auto type = builder.CreateAnd(insn_value_type(v).v, TypeFeedback::TYPES - 1);
+	auto base = builder.CreateIntToPtr(llvm::ConstantInt::get(int64, (uint64_t) counters), int64->getPointerTo());
+	auto counter = builder.CreateInBoundsGEP(int64, base, builder.CreateZExt(type, int64));
+	builder.CreateStore(builder.CreateAdd(builder.CreateLoad(int64, counter), llvm::ConstantInt::get(int64, 1)), counter);
+}
+
 Compiler::value Compiler::insn_class_of(Compiler::value v) {
 	assert(v.t->llvm(*this) == v.v->getType());
 	auto clazz = v.t->class_name();
@@ -1163,17 +1465,26 @@ void Compiler::insn_delete_temporary(Compiler::value v) {
 	}
 }
 
+/*
+ * Size of an array computed inline from its vector (end - begin), without a call, so LLVM
+ * can reuse it between the loop condition and the accesses
+ */
 Compiler::value Compiler::insn_array_size(Compiler::value v) {
 	assert(v.t->llvm(*this) == v.v->getType());
 	if (v.t->is_string()) {
 		return insn_call(env.integer, {v}, "String.isize");
 	} else if (v.t->is_array()) {
+		auto element = v.t->element()->fold();
 		if (v.t->element() == env.never) {
 			return new_integer(0);
-		} else if (v.t->element()->is_integer()) {
-			return insn_call(env.integer, {v}, "Array.isize.2");
-		} else if (v.t->element()->is_real()) {
-			return insn_call(env.integer, {v}, "Array.isize.1");
+		} else if (element->is_integer() or element->is_real() or element->is_long() or element->is_polymorphic()) {
+			auto begin = insn_load_member(v, 5);
+			auto end = insn_load_member(v, 6);
+			auto int64 = llvm::Type::getInt64Ty(getContext());
+			auto bytes = builder.CreateSub(builder.CreatePtrToInt(end.v, int64), builder.CreatePtrToInt(begin.v, int64));
+			uint64_t element_size = DL.getTypeAllocSize(v.t->element()->llvm(*this));
+			auto size = builder.CreateExactSDiv(bytes, llvm::ConstantInt::get(int64, element_size));
+			return { builder.CreateTrunc(size, env.integer->llvm(*this)), env.integer };
 		} else {
 			return insn_call(env.integer, {v}, "Array.isize");
 		}
@@ -1185,15 +1496,18 @@ Compiler::value Compiler::insn_array_size(Compiler::value v) {
 Compiler::value Compiler::insn_get_capture(int index, const Type* type) {
 	// std::cout << "get_capture " << fun->type << " " << fun->captures.size() << " captures " << F->arg_size() << " " << type << " " << index << std::endl;
 	assert(fun->parent->captures.size() > 0);
-	Compiler::value closure = { F->arg_begin(), env.any };
-	return insn_call(env.any, {closure, new_integer(index)}, "Function.get_capture");
+	return insn_load(insn_get_capture_l(index, env.any));
 }
 
+/*
+ * Address of a capture: the captures follow the closure in memory (LSClosure::CAPTURES_OFFSET)
+ */
 Compiler::value Compiler::insn_get_capture_l(int index, const Type* type) {
 	assert(type->is_polymorphic());
-	Compiler::value arg0 = {F->arg_begin(), env.any};
-	auto jit_index = new_integer(index);
-	return insn_call(type->pointer(), {arg0, jit_index}, "Function.get_capture_l", true);
+	auto int8 = llvm::Type::getInt8Ty(getContext());
+	auto closure = builder.CreatePointerCast(F->arg_begin(), int8->getPointerTo());
+	auto p = builder.CreateConstInBoundsGEP1_64(int8, closure, LSClosure::CAPTURES_OFFSET + index * sizeof(LSValue*));
+	return { builder.CreatePointerCast(p, type->pointer()->llvm(*this)), type->pointer() };
 }
 
 void Compiler::insn_push_array(Compiler::value array, Compiler::value value) {
@@ -1234,6 +1548,63 @@ Compiler::value Compiler::insn_array_end(Compiler::value array) {
 	return insn_load_member(array, 6);
 }
 
+Compiler::value Compiler::insn_interval_start(Compiler::value interval) {
+	assert(check_value(interval));
+	assert(interval.t->is_interval());
+	return insn_load_member(interval, 5);
+}
+
+Compiler::value Compiler::insn_interval_end(Compiler::value interval) {
+	assert(check_value(interval));
+	assert(interval.t->is_interval());
+	return insn_load_member(interval, 6);
+}
+
+Compiler::value Compiler::insn_interval_at(Compiler::value start, Compiler::value end, Compiler::value index) {
+	assert(check_value(start));
+	assert(check_value(end));
+	assert(check_value(index));
+	auto size = insn_add(insn_sub(end, start), new_integer(1));
+	insn_if(insn_or(insn_lt(index, new_integer(0)), insn_ge(index, size)), [&]() {
+		insn_throw_object(vm::Exception::ARRAY_OUT_OF_BOUNDS);
+	});
+	return insn_add(start, index);
+}
+
+Compiler::value Compiler::insn_interval_sum(Compiler::value start, Compiler::value end) {
+	assert(check_value(start));
+	assert(check_value(end));
+	// (b - a + 1) * (a + b) / 2, computed on 64 bits
+	auto a = builder.CreateSExt(start.v, env.long_->llvm(*this));
+	auto b = builder.CreateSExt(end.v, env.long_->llvm(*this));
+	auto size = builder.CreateAdd(builder.CreateSub(b, a), new_long(1).v);
+	return { builder.CreateSDiv(builder.CreateMul(size, builder.CreateAdd(a, b)), new_long(2).v), env.long_ };
+}
+
+Compiler::value Compiler::insn_interval_product(Compiler::value start, Compiler::value end) {
+	assert(check_value(start));
+	assert(check_value(end));
+	auto product = create_entry("product", env.long_);
+	auto i = create_entry("i", env.integer);
+	// An interval containing 0 has a null product
+	auto contains_zero = insn_and(insn_le(start, new_integer(0)), insn_gt(end, new_integer(0)));
+	insn_store(product, { builder.CreateSelect(contains_zero.v, new_long(0).v, new_long(1).v), env.long_ });
+	insn_store(i, start);
+	auto cond_label = insn_init_label("cond");
+	auto loop_label = insn_init_label("loop");
+	auto end_label = insn_init_label("end");
+	insn_if_new(contains_zero, &end_label, &cond_label);
+	insn_label(&cond_label);
+	insn_if_new(insn_gt(insn_load(i), end), &end_label, &loop_label);
+	insn_label(&loop_label);
+	auto x = builder.CreateSExt(insn_load(i).v, env.long_->llvm(*this));
+	insn_store(product, { builder.CreateMul(insn_load(product).v, x), env.long_ });
+	insn_store(i, insn_add(insn_load(i), new_integer(1)));
+	insn_branch(&cond_label);
+	insn_label(&end_label);
+	return insn_load(product);
+}
+
 Compiler::value Compiler::insn_move_inc(Compiler::value value) {
 	assert(check_value(value));
 	if (value.t->is_mpz_ptr()) {
@@ -1250,6 +1621,15 @@ Compiler::value Compiler::insn_move_inc(Compiler::value value) {
 	return value;
 }
 
+/*
+ * Move of a string into a local variable in copy-on-write, the string is shared
+ */
+Compiler::value Compiler::insn_share(Compiler::value value) {
+	assert(check_value(value));
+	assert(value.t->is_string());
+	return insn_call(value.t, {value}, "String.share");
+}
+
 Compiler::value Compiler::insn_clone_mpz(Compiler::value mpz) {
 	assert(check_value(mpz));
 	if (mpz.t->temporary) {
@@ -1261,6 +1641,93 @@ Compiler::value Compiler::insn_clone_mpz(Compiler::value mpz) {
 	return r;
 }
 
+/*
+ * Small-value fast path of the mpz: a value with at most one limb, below 2^63, is read and
+ * written inline as a long, GMP is only called for the big values and on overflow
+ */
+static llvm::Value* mpz_field(Compiler& c, Compiler::value mpz, size_t offset, llvm::Type* type) {
+	auto int8 = llvm::Type::getInt8Ty(c.getContext());
+	auto p = c.builder.CreateConstInBoundsGEP1_64(int8, c.builder.CreatePointerCast(mpz.v, int8->getPointerTo()), offset);
+	return c.builder.CreatePointerCast(p, type->getPointerTo());
+}
+
+Compiler::value Compiler::insn_mpz_is_small(Compiler::value mpz) {
+	assert(mpz.t->is_mpz_ptr());
+	auto int32 = llvm::Type::getInt32Ty(getContext());
+	auto int64 = llvm::Type::getInt64Ty(getContext());
+	auto size = builder.CreateLoad(int32, mpz_field(*this, mpz, offsetof(__mpz_struct, _mp_size), int32));
+	auto limbs = builder.CreateLoad(int64->getPointerTo(), mpz_field(*this, mpz, offsetof(__mpz_struct, _mp_d), int64->getPointerTo()));
+	auto limb = builder.CreateLoad(int64, limbs);
+	// -1 <= size <= 1 and (size == 0 or limb < 2^63)
+	auto one_limb = builder.CreateICmpULE(builder.CreateAdd(size, builder.getInt32(1)), builder.getInt32(2));
+	auto fits = builder.CreateOr(builder.CreateICmpEQ(size, builder.getInt32(0)), builder.CreateICmpSGE(limb, builder.getInt64(0)));
+	return { builder.CreateAnd(one_limb, fits), env.boolean };
+}
+
+Compiler::value Compiler::insn_mpz_get_small(Compiler::value mpz) {
+	assert(mpz.t->is_mpz_ptr());
+	auto int32 = llvm::Type::getInt32Ty(getContext());
+	auto int64 = llvm::Type::getInt64Ty(getContext());
+	auto size = builder.CreateLoad(int32, mpz_field(*this, mpz, offsetof(__mpz_struct, _mp_size), int32));
+	auto limbs = builder.CreateLoad(int64->getPointerTo(), mpz_field(*this, mpz, offsetof(__mpz_struct, _mp_d), int64->getPointerTo()));
+	auto limb = builder.CreateLoad(int64, limbs);
+	auto value = builder.CreateSelect(builder.CreateICmpSLT(size, builder.getInt32(0)), builder.CreateNeg(limb), limb);
+	return { builder.CreateSelect(builder.CreateICmpEQ(size, builder.getInt32(0)), builder.getInt64(0), value), env.long_ };
+}
+
+void Compiler::insn_mpz_set_small(Compiler::value mpz, Compiler::value l) {
+	assert(mpz.t->is_mpz_ptr());
+	assert(l.t->is_long());
+	auto int32 = llvm::Type::getInt32Ty(getContext());
+	auto int64 = llvm::Type::getInt64Ty(getContext());
+	auto alloc = builder.CreateLoad(int32, mpz_field(*this, mpz, offsetof(__mpz_struct, _mp_alloc), int32));
+	// The limb is allocated: write it, else let GMP allocate it
+	insn_if({ builder.CreateICmpSGT(alloc, builder.getInt32(0)), env.boolean }, [&]() {
+		auto limbs = builder.CreateLoad(int64->getPointerTo(), mpz_field(*this, mpz, offsetof(__mpz_struct, _mp_d), int64->getPointerTo()));
+		auto negative = builder.CreateICmpSLT(l.v, builder.getInt64(0));
+		builder.CreateStore(builder.CreateSelect(negative, builder.CreateNeg(l.v), l.v), limbs);
+		auto size = builder.CreateSelect(negative, builder.getInt32(-1), builder.CreateZExt(builder.CreateICmpNE(l.v, builder.getInt64(0)), int32));
+		builder.CreateStore(size, mpz_field(*this, mpz, offsetof(__mpz_struct, _mp_size), int32));
+	}, [&]() {
+		insn_call(env.void_, {mpz, l}, "Number.mpz_set_si");
+	});
+}
+
+/*
+ * r = a op b, op being an overflow intrinsic (sadd, ssub, smul), with `a` small, else `generic` (GMP)
+ */
+void Compiler::insn_mpz_small_op(Compiler::value r, Compiler::value a, Compiler::value b, llvm::Intrinsic::ID op, std::function<void()> generic) {
+	auto done = create_entry("done", env.boolean);
+	insn_store(done, new_bool(false));
+	insn_if(insn_mpz_is_small(a), [&]() {
+		auto int64 = llvm::Type::getInt64Ty(getContext());
+		auto function = llvm::Intrinsic::getDeclaration(F->getParent(), op, { int64 });
+		auto result = builder.CreateCall(function, { insn_mpz_get_small(a).v, to_long(b).v });
+		insn_if_not({ builder.CreateExtractValue(result, 1), env.boolean }, [&]() {
+			insn_mpz_set_small(r, { builder.CreateExtractValue(result, 0), env.long_ });
+			insn_store(done, new_bool(true));
+		});
+	});
+	insn_if_not(insn_load(done), generic);
+}
+
+/*
+ * Comparison of an mpz with an integer (-1, 0, 1), inline for the small values
+ */
+Compiler::value Compiler::insn_mpz_cmp_si(Compiler::value a, Compiler::value b) {
+	auto r = create_entry("cmp", env.integer);
+	insn_if(insn_mpz_is_small(a), [&]() {
+		auto x = insn_mpz_get_small(a).v;
+		auto y = to_long(b).v;
+		auto gt = builder.CreateZExt(builder.CreateICmpSGT(x, y), llvm::Type::getInt32Ty(getContext()));
+		auto lt = builder.CreateZExt(builder.CreateICmpSLT(x, y), llvm::Type::getInt32Ty(getContext()));
+		insn_store(r, { builder.CreateSub(gt, lt), env.integer });
+	}, [&]() {
+		insn_store(r, insn_call(env.integer, {a, b}, "Number._mpz_cmp_si"));
+	});
+	return insn_load(r);
+}
+
 void Compiler::insn_delete_mpz(Compiler::value mpz) {
 	// std::cout << "delete mpz " << mpz.t << std::endl;
 	assert(check_value(mpz));
@@ -1865,7 +2332,7 @@ void Compiler::insn_throw(Compiler::value v) {
 
 		auto ex = insn_call(env.i8_ptr, { new_integer(sizeof(vm::ExceptionObj)) }, "__cxa_allocate_exception");
 		auto ex_obj = insn_call(env.i8_ptr, { ex, v, file, function_name, line  }, "System.new_exception");
-		insn_call(env.void_, {ex_obj, new_long((long) &typeid(vm::ExceptionObj)), get_symbol("System.delete_exception", env.i8_ptr)}, "__cxa_throw");
+		insn_call(env.void_, {ex_obj, exception_type(), get_symbol("System.delete_exception", env.i8_ptr)}, "__cxa_throw");
 
 		// insn_call(env.void_, {v, file, function_name, line}, "System.throw");
 	}
@@ -1956,6 +2423,7 @@ Compiler::value Compiler::insn_invoke(const Type* return_type, std::vector<Compi
 		llvm_types.push_back(args[i].t->llvm(*this));
 	}
 	llvm::Function* lambda;
+	if (name.compare(0, 14, "Value.operator") == 0) insn_count(offsetof(LSValue::Counters, generic_calls));
 	auto name2 = std::count(name.begin(), name.end(), '.') == 2 ? name : name + ".0";
 	auto p = mappings.find({ name2, return_type });
 	if (p == mappings.end()) {
@@ -2022,6 +2490,7 @@ Compiler::value Compiler::insn_call(const Type* return_type, std::vector<Compile
 		llvm_args.push_back(args[i].v);
 	}
 	llvm::Function* lambda;
+	if (name.compare(0, 14, "Value.operator") == 0) insn_count(offsetof(LSValue::Counters, generic_calls));
 	auto name2 = (std::count(name.begin(), name.end(), '.') == 2 or name.find("__cxa") != std::string::npos) ? name : name + ".0";
 	auto p = mappings.find({ name2, return_type });
 	if (p == mappings.end()) {
@@ -2260,8 +2729,10 @@ Section* Compiler::current_section() const {
 // Variables
 
 Compiler::value Compiler::add_external_var(Variable* variable) {
+	// In a batch, the programs can have different contexts
+	auto symbol = "ctx." + variable->name + (batch_index >= 0 ? "." + std::to_string(batch_index) : "");
 	variable->entry = create_entry("ctx." + variable->name, variable->type);
-	insn_store(variable->entry, insn_load(get_symbol("ctx." + variable->name, variable->type->pointer())));
+	insn_store(variable->entry, insn_load(get_symbol(symbol, variable->type->pointer())));
 	return variable->entry;
 }
 
@@ -2319,9 +2790,25 @@ int Compiler::get_current_loop_blocks(int deepness) const {
 
 /** Operations **/
 void Compiler::inc_ops(int amount) {
+	insn_check_memory();
 	if (not vm->enable_operations) return;
 	inc_ops_jit(new_integer(amount));
 }
+
+/*
+ * Throw if a builtin has gone past the memory limit (VM::memory.exceeded), at the same
+ * points as the operations: the variables are deleted and a try/catch can catch it
+ */
+void Compiler::insn_check_memory() {
+	if (not memory_limit) return;
+	auto int8 = llvm::Type::getInt8Ty(getContext());
+	auto flag = get_symbol("memory_exceeded", env.i8->pointer());
+	auto exceeded = builder.CreateICmpNE(builder.CreateLoad(int8, flag.v), llvm::ConstantInt::get(int8, 0));
+	insn_if({ exceeded, env.boolean }, [&]() {
+		builder.CreateStore(llvm::ConstantInt::get(int8, 0), flag.v);
+		insn_throw_object(vm::Exception::MEMORY_LIMIT_EXCEEDED);
+	});
+}
 void Compiler::inc_ops_jit(Compiler::value amount) {
 	assert(amount.t->llvm(*this) == amount.v->getType());
 	assert(amount.t->is_number());
@@ -2345,6 +2832,15 @@ void Compiler::inc_ops_jit(Compiler::value amount) {
 	insn_store(ops_ptr, insn_add(jit_ops, amount));
 }
 
+void Compiler::insn_count(size_t counter) {
+	if (not instrumentation) return;
+	auto int8 = llvm::Type::getInt8Ty(getContext());
+	auto counters = get_symbol("counters", env.i8->pointer());
+	auto ptr = builder.CreatePointerCast(builder.CreateConstInBoundsGEP1_64(int8, counters.v, counter), env.long_->pointer()->llvm(*this));
+	auto value = insn_load({ ptr, env.long_->pointer() });
+	insn_store({ ptr, env.long_->pointer() }, insn_add(value, new_long(1)));
+}
+
 /** Exceptions **/
 void Compiler::mark_offset(int line) {
 	exception_line.top() = line;
@@ -2426,19 +2922,26 @@ bool Compiler::check_value_not_void(value v) const {
 	return check_value(v);
 }
 
+/*
+ * The mpz counters are only maintained in the leak-checking builds (DEBUG_LEAKS)
+ */
 void Compiler::increment_mpz_created() {
-	// Get the mpz_created counter global variable
-	auto mpz = get_symbol("mpzc", env.integer->pointer());
-	// Increment counter
-	auto v = insn_load(mpz);
-	insn_store(mpz, insn_add(v, new_integer(1)));
+	#if DEBUG_LEAKS
+		// Get the mpz_created counter global variable
+		auto mpz = get_symbol("mpzc", env.integer->pointer());
+		// Increment counter
+		auto v = insn_load(mpz);
+		insn_store(mpz, insn_add(v, new_integer(1)));
+	#endif
 }
 void Compiler::increment_mpz_deleted() {
-	// Get the mpz_deleted counter global variable
-	auto mpz = get_symbol("mpzd", env.integer->pointer());
-	// Increment counter
-	auto v = insn_load(mpz);
-	insn_store(mpz, insn_add(v, new_integer(1)));
+	#if DEBUG_LEAKS
+		// Get the mpz_deleted counter global variable
+		auto mpz = get_symbol("mpzd", env.integer->pointer());
+		// Increment counter
+		auto v = insn_load(mpz);
+		insn_store(mpz, insn_add(v, new_integer(1)));
+	#endif
 }
 
 }
@@ -9,6 +9,7 @@
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
@@ -16,6 +17,7 @@
 #include "llvm/IR/Verifier.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/Scalar.h"
 #include "llvm/Transforms/Scalar/GVN.h"
 #include "llvm/ADT/STLExtras.h"
@@ -35,6 +37,7 @@
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
 #include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
+#include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Mangler.h"
 #include "llvm/Support/DynamicLibrary.h"
@@ -42,6 +45,8 @@
 #include "llvm/Target/TargetMachine.h"
 #include "../vm/Exception.hpp"
 #include "../vm/LSValue.hpp"
+#include "TypeFeedback.hpp"
+#include "VersionCache.hpp"
 #include <gmp.h>
 
 namespace ls {
@@ -58,6 +63,14 @@ class Section;
 
 class Compiler {
 public:
+
+	/* Cost threshold of the inliner (LLVM's default at -O2) */
+	static const int INLINE_THRESHOLD = 225;
+	/* Programs with this number of functions per compilation thread are compiled lazily, function by function */
+	static const size_t LAZY_FUNCTIONS = 50;
+	/* Functions per thread when a program is optimized and compiled in parallel */
+	static const size_t PARALLEL_FUNCTIONS = 16;
+
 	struct value {
 		llvm::Value* v;
 		const Type* t;
@@ -101,10 +114,22 @@ public:
 	std::stack<int> exception_line;
 	bool export_bitcode = false;
 	bool export_optimized_ir = false;
+	bool export_object = false;
 	std::unordered_map<std::string, Compiler::value> global_strings;
+	TypeFeedback feedback;
+	VersionCache versions;
+	bool lazy_compilation = true;
+	bool instrumentation = false; // count the boxings and the generic calls (VM::memory.counters)
+	bool memory_limit = false; // check VM::memory.exceeded
+	bool copy_on_write = false; // share the strings between the local variables (LSString::share)
+	std::set<llvm::orc::VModuleKey> lazy_modules;
+	std::map<llvm::orc::VModuleKey, std::shared_ptr<llvm::orc::SymbolResolver>> resolvers; // of the partitions of the lazy and parallel modules
+	bool parallel_compilation = true;
+	std::map<llvm::orc::VModuleKey, std::vector<llvm::orc::VModuleKey>> parallel_modules; // objects of the parts of the module
 
 	VM* vm;
 	Program* program;
+	int batch_index = -1; // of the program in its batch, suffix of its ctx symbols
 
 	std::unique_ptr<llvm::TargetMachine> TM;
 	llvm::DataLayout DL;
@@ -113,6 +138,8 @@ public:
 	llvm::orc::LegacyIRCompileLayer<decltype(ObjectLayer), llvm::orc::SimpleCompiler> CompileLayer;
 	using OptimizeFunction = std::function<std::unique_ptr<llvm::Module>(std::unique_ptr<llvm::Module>)>;
 	llvm::orc::LegacyIRTransformLayer<decltype(CompileLayer), OptimizeFunction> OptimizeLayer;
+	std::unique_ptr<llvm::orc::JITCompileCallbackManager> CompileCallbackManager;
+	llvm::orc::LegacyCompileOnDemandLayer<decltype(OptimizeLayer)> CODLayer;
 
 	Compiler(Environment& env, VM* vm);
 
@@ -121,13 +148,55 @@ public:
 	llvm::LLVMContext& getContext() { return *Ctx.getContext(); }
 
 	std::unique_ptr<llvm::Module> optimizeModule(std::unique_ptr<llvm::Module> M);
-	llvm::orc::VModuleKey addModule(std::unique_ptr<llvm::Module> M, bool optimize, bool export_bitcode = false, bool export_optimized_ir = false);
+	void inline_functions(llvm::Module& M);
+	void optimize_functions(llvm::Module& M);
+	void register_symbols(llvm::orc::VModuleKey K, const llvm::object::ObjectFile& object, const llvm::RuntimeDyld::LoadedObjectInfo& info);
+	llvm::JITSymbol resolve(const std::string& Name);
+	std::shared_ptr<llvm::orc::SymbolResolver> create_resolver();
+	llvm::orc::VModuleKey addModule(std::unique_ptr<llvm::Module> M, bool optimize, bool export_bitcode = false, bool export_optimized_ir = false, bool export_object = false);
+	/* Native object compiled ahead of time (--object), linked with the runtime symbols */
+	llvm::orc::VModuleKey addObject(std::unique_ptr<llvm::MemoryBuffer> object);
+	std::set<llvm::orc::VModuleKey> object_modules;
+	/* Each function is behind a stub, optimized and compiled on its first call */
+	llvm::orc::VModuleKey addLazyModule(std::unique_ptr<llvm::Module> M);
+	/* The module is split, its parts are optimized and compiled by `threads` threads */
+	unsigned compilation_threads(const llvm::Module& M) const;
+	unsigned compilation_threads(size_t functions) const;
+	llvm::orc::VModuleKey addParallelModule(std::unique_ptr<llvm::Module> M, unsigned threads);
 
 	llvm::JITSymbol findSymbol(const std::string Name) {
 		return OptimizeLayer.findSymbol(Name, false);
 	}
+	llvm::JITSymbol findSymbolIn(llvm::orc::VModuleKey K, const std::string Name) {
+		if (lazy_modules.count(K)) {
+			return CODLayer.findSymbolIn(K, Name, false);
+		}
+		if (object_modules.count(K)) {
+			return ObjectLayer.findSymbolIn(K, Name, false);
+		}
+		auto parts = parallel_modules.find(K);
+		if (parts != parallel_modules.end()) {
+			for (auto part : parts->second) {
+				if (auto Sym = ObjectLayer.findSymbolIn(part, Name, false)) return Sym;
+			}
+			return nullptr;
+		}
+		return OptimizeLayer.findSymbolIn(K, Name, false);
+	}
 	void removeModule(llvm::orc::VModuleKey K) {
-		cantFail(OptimizeLayer.removeModule(K));
+		auto parts = parallel_modules.find(K);
+		if (lazy_modules.erase(K)) {
+			cantFail(CODLayer.removeModule(K));
+		} else if (object_modules.erase(K)) {
+			cantFail(ObjectLayer.removeObject(K));
+		} else if (parts != parallel_modules.end()) {
+			for (auto part : parts->second) {
+				cantFail(ObjectLayer.removeObject(part));
+			}
+			parallel_modules.erase(parts);
+		} else {
+			cantFail(OptimizeLayer.removeModule(K));
+		}
 	}
 
 	/// CreateEntryBlockAlloca - Create an alloca instruction in the entry block of the function.  This is used for mutable variables etc.
@@ -139,6 +208,7 @@ public:
 	// Value creation
 	value clone(value);
 	value new_null();
+	value exception_type(); // address of the typeinfo of vm::ExceptionObj, for __cxa_throw
 	value new_bool(bool b);
 	value new_integer(int i);
 	value new_real(double r);
@@ -192,6 +262,8 @@ public:
 	value insn_mod(value, value, bool check_overflow = true);
 	value insn_double_mod(value, value);
 	value insn_cmpl(value, value);
+	value insn_speculate(value, value, const Type* type, std::function<value(value, value)> fast, std::function<value()> generic);
+	value insn_number_result(value r, value a, value b);
 
 	// Math Functions
 	value insn_log(value);
@@ -221,6 +293,10 @@ public:
 	void  insn_store(value, value);
 	void  insn_store_member(value, int, value);
 	value insn_typeof(value v);
+	value insn_value_type(value v);
+	value insn_number_value(value v);
+	llvm::Value* number_address(value v);
+	void  insn_record_type(value v, int64_t* counters);
 	value insn_class_of(value v);
 	void  insn_delete(value v);
 	void  insn_delete_variable(value v);
@@ -228,8 +304,14 @@ public:
 	value insn_get_capture(int index, const Type* type);
 	value insn_get_capture_l(int index, const Type* type);
 	value insn_move_inc(value);
+	value insn_share(value);
 	value insn_clone_mpz(value mpz);
 	void  insn_delete_mpz(value mpz);
+	value insn_mpz_is_small(value mpz);
+	value insn_mpz_get_small(value mpz);
+	void  insn_mpz_set_small(value mpz, value l);
+	void  insn_mpz_small_op(value r, value a, value b, llvm::Intrinsic::ID op, std::function<void()> generic);
+	value insn_mpz_cmp_si(value a, value b);
 	value insn_inc_refs(value v);
 	value insn_dec_refs(value v);
 	value insn_move(value v);
@@ -243,6 +325,13 @@ public:
 	value insn_array_at(value array, value index);
 	value insn_array_end(value array);
 
+	// Intervals
+	value insn_interval_start(value interval);
+	value insn_interval_end(value interval);
+	value insn_interval_at(value start, value end, value index);
+	value insn_interval_sum(value start, value end);
+	value insn_interval_product(value start, value end);
+
 	// Iterators
 	value iterator_begin(value v);
 	value iterator_rbegin(value v);
@@ -315,6 +404,8 @@ public:
 	/** Operations **/
 	void inc_ops(int add);
 	void inc_ops_jit(value add);
+	void insn_check_memory();
+	void insn_count(size_t counter); // offset in LSValue::Counters
 
 	/** Exceptions **/
 	void mark_offset(int line);
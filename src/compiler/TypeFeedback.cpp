@@ -0,0 +1,60 @@
+#include "TypeFeedback.hpp"
+#include <cstddef>
+#include "../vm/value/LSNumber.hpp"
+
+namespace ls {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+const size_t TypeFeedback::TYPE_OFFSET = offsetof(LSValue, type);
+const size_t TypeFeedback::NUMBER_OFFSET = offsetof(LSNumber, value);
+#pragma GCC diagnostic pop
+
+std::shared_ptr<TypeFeedback::Profile> TypeFeedback::start(const std::string& file, const std::string& code) {
+	position = 0;
+	if (not enabled) {
+		current = nullptr;
+		return nullptr;
+	}
+	auto key = file + ":" + std::to_string(std::hash<std::string>{}(code));
+	auto i = profiles.find(key);
+	if (i == profiles.end()) {
+		// The compiled programs keep their profile alive
+		if (profiles.size() >= MAX_PROGRAMS) profiles.clear();
+		i = profiles.emplace(key, std::make_shared<Profile>()).first;
+	}
+	current = i->second;
+	return current;
+}
+
+TypeFeedback::Site* TypeFeedback::next_site() {
+	if (not current) return nullptr;
+	if (position == current->sites.size()) {
+		current->sites.emplace_back();
+	}
+	return &current->sites[position++];
+}
+
+std::shared_ptr<TypeFeedback::Profile> TypeFeedback::suspend() {
+	auto profile = current;
+	current = nullptr;
+	return profile;
+}
+
+void TypeFeedback::resume(std::shared_ptr<Profile> profile) {
+	current = profile;
+}
+
+TypeFeedback::Tier TypeFeedback::tier(Site* site, bool any_a, bool any_b) const {
+	bool any[2] = { any_a, any_b };
+	for (int o = 0; o < 2; ++o) {
+		if (not any[o]) continue;
+		int64_t total = 0;
+		for (int t = 0; t < TYPES; ++t) total += site->types[o][t];
+		if (total < MIN_SAMPLES) return Tier::PROFILE;
+		if (site->types[o][LSValue::NUMBER] * 100 < total * DOMINANT_PERCENT) return Tier::GENERIC;
+	}
+	return Tier::NUMBER;
+}
+
+}
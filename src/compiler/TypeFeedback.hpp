@@ -0,0 +1,64 @@
+#ifndef TYPE_FEEDBACK_HPP
+#define TYPE_FEEDBACK_HPP
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+#include "../vm/LSValue.hpp"
+
+namespace ls {
+
+/**
+ * Type feedback of the `any` operations (+, -, ==, <)
+ *
+ * The first compilation of a program instruments each operation site with a cheap
+ * counter of the runtime types (LSValueType) of its `any` operands. When the same
+ * program (file and code) is compiled again in the environment, the sites where a single
+ * type dominates are compiled with an inline type check and an unboxed fast path,
+ * falling back to the generic `Value.operator` call.
+ * Sites are identified by their order of compilation, which is deterministic for a code.
+ */
+class TypeFeedback {
+public:
+
+	static const int TYPES = 16;
+	static const int64_t MIN_SAMPLES = 16;
+	static const int DOMINANT_PERCENT = 95;
+	static const size_t MAX_PROGRAMS = 1000;
+
+	/* Offsets of LSValue::type and LSNumber::value, read by the generated code */
+	static const size_t TYPE_OFFSET;
+	static const size_t NUMBER_OFFSET;
+
+	enum class Tier { PROFILE, GENERIC, NUMBER };
+
+	struct Site {
+		int64_t types[2][TYPES] = {}; // observed types of each operand
+	};
+	struct Profile {
+		std::deque<Site> sites; // stable addresses, referenced by the JIT'd code
+	};
+
+	bool enabled = true;
+
+	/** Select the profile of the program before its compilation */
+	std::shared_ptr<Profile> start(const std::string& file, const std::string& code);
+	/** Next operation site of the program being compiled */
+	Site* next_site();
+	/** How to compile a site, from its feedback */
+	Tier tier(Site* site, bool any_a, bool any_b) const;
+	/** Compile without sites (code shared by several programs), then continue the program */
+	std::shared_ptr<Profile> suspend();
+	void resume(std::shared_ptr<Profile> profile);
+
+private:
+	std::unordered_map<std::string, std::shared_ptr<Profile>> profiles;
+	std::shared_ptr<Profile> current;
+	size_t position = 0;
+};
+
+}
+
+#endif
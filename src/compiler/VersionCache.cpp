@@ -0,0 +1,62 @@
+#include "VersionCache.hpp"
+#include "Compiler.hpp"
+#include "../analyzer/Program.hpp"
+#include "../vm/VM.hpp"
+
+namespace ls {
+
+std::string VersionCache::get(Compiler& c, const std::string& key, const std::string& name, std::function<void(const std::string& symbol)> compile) {
+	// The profiler needs the functions in the module of the program (frame pointers, names),
+	// an exported object can't refer to the modules of the JIT
+	if (not enabled or c.vm->profiler.enabled) {
+		compile("");
+		return "";
+	}
+	auto i = versions.find(key);
+	if (i != versions.end()) {
+		hits++;
+		return i->second.symbol;
+	}
+	if (versions.size() >= MAX_VERSIONS) {
+		compile("");
+		return "";
+	}
+
+	// Compile the version alone in a new module, with its own declarations and strings
+	auto symbol = "cache." + std::to_string(modules++) + "." + (name.size() ? name : "anonymous");
+	auto program_module = c.program->module;
+	auto module = new llvm::Module(symbol, c.getContext());
+	module->setDataLayout(c.DL);
+	c.program->module = module;
+	decltype(c.mappings) mappings;
+	decltype(c.global_strings) global_strings;
+	std::swap(mappings, c.mappings);
+	std::swap(global_strings, c.global_strings);
+	auto profile = c.feedback.suspend();
+
+	compile(symbol);
+	auto type = module->getFunction(symbol)->getFunctionType();
+
+	c.feedback.resume(profile);
+	std::swap(mappings, c.mappings);
+	std::swap(global_strings, c.global_strings);
+	c.program->module = program_module;
+
+	// Never removed: the next programs link it
+	if (c.program->lazy) {
+		c.addLazyModule(std::unique_ptr<llvm::Module>(module));
+	} else {
+		c.addModule(std::unique_ptr<llvm::Module>(module), true);
+	}
+	versions.insert({ key, { symbol, type } });
+	return symbol;
+}
+
+llvm::Function* VersionCache::declare(Compiler& c, const std::string& symbol, llvm::FunctionType* type) {
+	if (auto f = c.program->module->getFunction(symbol)) {
+		return f;
+	}
+	return llvm::Function::Create(type, llvm::Function::ExternalLinkage, symbol, c.program->module);
+}
+
+}
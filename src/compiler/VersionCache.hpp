@@ -0,0 +1,54 @@
+#ifndef VERSION_CACHE_HPP
+#define VERSION_CACHE_HPP
+
+#include <string>
+#include <functional>
+#include <unordered_map>
+
+namespace llvm {
+	class Function;
+	class FunctionType;
+}
+
+namespace ls {
+
+class Compiler;
+
+/**
+ * Cache of the compiled function versions, shared by the programs of the environment
+ *
+ * A version that only uses its arguments, its own variables and the standard library
+ * (no captures, no other function or global of the program) produces the same code in
+ * every program: it's compiled once in its own module, kept by the JIT, and the next
+ * programs only declare it. The key is (file, position and hash of the source of the
+ * function, type of the version, flags of the environment).
+ */
+class VersionCache {
+public:
+
+	static const size_t MAX_VERSIONS = 10000;
+
+	bool enabled = true;
+	long hits = 0;
+
+	/**
+	 * Symbol of the cached version, compiled by `compile(symbol)` in a new module of the cache
+	 * the first time. Empty if the version is not cached: compiled by `compile("")` in the program.
+	 */
+	std::string get(Compiler& c, const std::string& key, const std::string& name, std::function<void(const std::string& symbol)> compile);
+	/** Declaration of a cached function in the current module */
+	llvm::Function* declare(Compiler& c, const std::string& symbol, llvm::FunctionType* type);
+	size_t size() const { return versions.size(); }
+
+private:
+	struct Version {
+		std::string symbol;
+		llvm::FunctionType* type;
+	};
+	std::unordered_map<std::string, Version> versions;
+	size_t modules = 0;
+};
+
+}
+
+#endif
@@ -35,6 +35,7 @@
 #include "../analyzer/semantic/SemanticAnalyzer.hpp"
 #include "../util/utf8.h"
 #include "../analyzer/resolver/Resolver.hpp"
+#include <mutex>
 
 namespace ls {
 
@@ -107,6 +108,60 @@ Environment::~Environment() {
 	delete convert_mutator_array_size;
 }
 
+/*
+ * Released environments, by legacy mode. The ones left at the exit are not destroyed.
+ */
+static std::mutex pool_mutex;
+static std::vector<Environment*> pool[2];
+
+std::shared_ptr<Environment> Environment::acquire(bool legacy) {
+	Environment* env = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(pool_mutex);
+		auto& envs = pool[legacy];
+		if (envs.size()) {
+			env = envs.back();
+			envs.pop_back();
+		}
+	}
+	if (not env) {
+		env = new Environment(legacy);
+	}
+	return std::shared_ptr<Environment>(env, [](Environment* env) {
+		env->reset_options();
+		{
+			std::lock_guard<std::mutex> lock(pool_mutex);
+			auto& envs = pool[env->legacy];
+			if (envs.size() < POOL_SIZE) {
+				envs.push_back(env);
+				return;
+			}
+		}
+		delete env;
+	});
+}
+
+void Environment::reset_options() {
+	output = nullptr;
+	operation_limit = -1;
+	memory_limit = 0;
+	profile = false;
+	type_feedback = true;
+	lazy_compilation = true;
+	parallel_compilation = true;
+	max_function_versions = 8;
+	instrumentation = false;
+	copy_on_write = false;
+	#if COMPILER
+	vm.output = VM::default_output;
+	// The options already copied to the VM and the compiler, baked in the next compilations
+	vm.operation_limit = VM::DEFAULT_OPERATION_LIMIT;
+	vm.memory_limit = 0;
+	compiler_options(false);
+	vm.enable_operations = true;
+	#endif
+}
+
 void Environment::analyze(Program& program, bool format, bool debug, bool sections) {
 	auto resolver = new Resolver();
 	SyntaxicAnalyzer syn { *this, resolver, program.main_file };
@@ -127,9 +182,25 @@ Hover Environment::hover(Program& program, File* file, size_t position) {
 
 #if COMPILER
 
-void Environment::compile(Program& program, bool format, bool debug, bool ops, bool assembly, bool pseudo_code, bool optimized_ir, bool execute_ir, bool execute_bitcode) {
+void Environment::compiler_options(bool ops) {
 	vm.enable_operations = ops or operation_limit > 0;
-	program.compile(compiler, format, debug, assembly, pseudo_code, optimized_ir, execute_ir, execute_bitcode);
+	vm.profiler.enabled = profile;
+	compiler.feedback.enabled = type_feedback;
+	compiler.lazy_compilation = lazy_compilation;
+	compiler.instrumentation = instrumentation;
+	compiler.memory_limit = memory_limit > 0;
+	compiler.copy_on_write = copy_on_write;
+	compiler.parallel_compilation = parallel_compilation;
+}
+
+void Environment::compile(Program& program, bool format, bool debug, bool ops, bool assembly, bool pseudo_code, bool optimized_ir, bool execute_ir, bool execute_bitcode, bool export_object, bool execute_object) {
+	compiler_options(ops);
+	program.compile(compiler, format, debug, assembly, pseudo_code, optimized_ir, execute_ir, execute_bitcode, export_object, execute_object);
+}
+
+void Environment::compile(const std::vector<Program*>& programs, bool ops) {
+	compiler_options(ops);
+	Program::compile_batch(compiler, programs);
 }
 
 void Environment::execute(Program& program, bool format, bool debug, bool ops, bool assembly, bool pseudo_code, bool optimized_ir, bool execute_ir, bool execute_bitcode) {
@@ -140,7 +211,9 @@ void Environment::execute(Program& program, bool format, bool debug, bool ops, b
 	if (operation_limit != -1) {
 		vm.operation_limit = operation_limit;
 	}
+	vm.memory_limit = memory_limit;
 	vm.execute(program, format, debug, ops, assembly, pseudo_code, optimized_ir, execute_ir, execute_bitcode);
+	vm.output->flush();
 }
 
 #endif
@@ -63,10 +63,22 @@ private:
 	std::unordered_map<const Type*, std::unique_ptr<const Type>> meta_not_void_types;
 	std::vector<std::unique_ptr<const Type>> template_types;
 
+	#if COMPILER
+	void compiler_options(bool ops);
+	#endif
+
 public:
 	bool legacy = false;
 	OutputStream* output = nullptr;
 	int operation_limit = -1;
+	long memory_limit = 0; // bytes, 0 : no limit
+	bool profile = false;
+	bool type_feedback = true; // speculate on the types observed by the previous compilations
+	bool lazy_compilation = true; // compile the functions of the big programs on their first call
+	bool parallel_compilation = true; // optimize and compile the big programs with several threads
+	int max_function_versions = 8; // versions of a function specialized by the argument types (-1 : no limit)
+	bool instrumentation = false; // count the boxings, generic calls, clones, reallocations, exceptions and allocations
+	bool copy_on_write = false; // a string assigned to another local variable is shared until one of them is modified
 
     const Type* const void_;
 	const Type* const boolean;
@@ -131,6 +143,16 @@ public:
     Environment(bool legacy);
 	virtual ~Environment();
 
+	/**
+	 * Environment taken from the pool of the released ones, or built if the pool is empty.
+	 * Building one (standard library, types, classes, JIT) is the fixed cost of a script:
+	 * the short-lived scripts and the workers share a few warm environments instead.
+	 * It goes back to the pool, with its default options, when the last pointer is released.
+	 */
+	static std::shared_ptr<Environment> acquire(bool legacy = false);
+	static const size_t POOL_SIZE = 8;
+	void reset_options();
+
 	/**
 	 * Analyze a `Program`.
 	 */
@@ -150,7 +172,14 @@ public:
 	/**
 	 * Compile a `Program`.
 	 */
-	void compile(Program& program, bool format = false, bool debug = false, bool ops = false, bool assembly = false, bool pseudo_code = false, bool optimized_ir = false, bool execute_ir = false, bool execute_bitcode = false);
+	void compile(Program& program, bool format = false, bool debug = false, bool ops = false, bool assembly = false, bool pseudo_code = false, bool optimized_ir = false, bool execute_ir = false, bool execute_bitcode = false, bool export_object = false, bool execute_object = false);
+
+	/**
+	 * Compile several analyzed `Program`s together: one module, one optimization and one
+	 * code generation (on several threads for a big batch). Each program keeps its entry
+	 * point and its result, and is executed alone.
+	 */
+	void compile(const std::vector<Program*>& programs, bool ops = false);
 
 	/**
 	 * Execute a `Program`.
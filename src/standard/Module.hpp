@@ -47,6 +47,7 @@ public:
 	static int NO_RETURN;
 	static int PRIVATE;
 	static int LEGACY_ONLY;
+	static int SHARE; // assignment of a string shared by copy-on-write
 
 	static bool STORE_ARRAY_SIZE;
 
@@ -21,7 +21,7 @@ FunctionSTD::FunctionSTD(Environment& env) : Module(env, "Function") {
 
 	constructor_({
 		{Type::fun_object(env.void_, {}), {env.i8_ptr, env.i8_ptr}, ADDR((void*) LSFunction::constructor)},
-		{Type::closure(env.void_, {}), {env.i8_ptr, env.i8_ptr}, ADDR((void*) LSClosure::constructor)},
+		{Type::closure(env.void_, {}), {env.i8_ptr, env.i8_ptr, env.integer}, ADDR((void*) LSClosure::constructor)},
 	});
 
 	/** Internal **/
@@ -53,10 +53,10 @@ IntervalSTD::IntervalSTD(Environment& env) : Module(env, "Interval") {
 	});
 
 	method("sum", {
-		{env.long_, {env.interval}, ADDR((void*) LSInterval::std_sum)},
+		{env.long_, {env.interval}, ADDR(sum)},
 	});
 	method("product", {
-		{env.long_, {env.interval}, ADDR((void*) LSInterval::std_product)},
+		{env.long_, {env.interval}, ADDR(product)},
 	});
 
 	/** Interval **/
@@ -67,4 +67,20 @@ IntervalSTD::IntervalSTD(Environment& env) : Module(env, "Interval") {
 
 IntervalSTD::~IntervalSTD() {}
 
+#if COMPILER
+
+Compiler::value IntervalSTD::sum(Compiler& c, std::vector<Compiler::value> args, int) {
+	auto r = c.insn_interval_sum(c.insn_interval_start(args[0]), c.insn_interval_end(args[0]));
+	c.insn_delete_temporary(args[0]);
+	return r;
+}
+
+Compiler::value IntervalSTD::product(Compiler& c, std::vector<Compiler::value> args, int) {
+	auto r = c.insn_interval_product(c.insn_interval_start(args[0]), c.insn_interval_end(args[0]));
+	c.insn_delete_temporary(args[0]);
+	return r;
+}
+
+#endif
+
 }
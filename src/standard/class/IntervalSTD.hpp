@@ -9,6 +9,11 @@ class IntervalSTD : public Module {
 public:
 	IntervalSTD(Environment& env);
 	virtual ~IntervalSTD();
+
+	#if COMPILER
+	static Compiler::value sum(Compiler&, std::vector<Compiler::value>, int);
+	static Compiler::value product(Compiler&, std::vector<Compiler::value>, int);
+	#endif
 };
 
 }
@@ -415,6 +415,9 @@ NumberSTD::NumberSTD(Environment& env) : Module(env, "Number") {
 	method("mpz_get_ui", {
 		{env.long_, {env.mpz_ptr}, ADDR((void*) mpz_get_ui)}
 	}, PRIVATE);
+	method("mpz_set_si", {
+		{env.void_, {env.mpz_ptr, env.long_}, ADDR((void*) mpz_set_si)}
+	}, PRIVATE);
 	method("mpz_get_si", {
 		{env.long_, {env.mpz_ptr}, ADDR((void*) mpz_get_si)}
 	}, PRIVATE);
@@ -592,12 +595,12 @@ Compiler::value NumberSTD::eq_mpz_mpz(Compiler& c, std::vector<Compiler::value>
 	return r;
 }
 Compiler::value NumberSTD::eq_int_mpz(Compiler& c, std::vector<Compiler::value> args, int) {
-	auto r = c.insn_eq(c.insn_call(c.env.integer, {args[1], args[0]}, "Number._mpz_cmp_si"), c.new_integer(0));
+	auto r = c.insn_eq(c.insn_mpz_cmp_si(args[1], args[0]), c.new_integer(0));
 	c.insn_delete_temporary(args[1]);
 	return r;
 }
 Compiler::value NumberSTD::eq_mpz_int(Compiler& c, std::vector<Compiler::value> args, int) {
-	auto r = c.insn_eq(c.insn_call(c.env.integer, args, "Number._mpz_cmp_si"), c.new_integer(0));
+	auto r = c.insn_eq(c.insn_mpz_cmp_si(args[0], args[1]), c.new_integer(0));
 	c.insn_delete_temporary(args[0]);
 	return r;
 }
@@ -623,10 +626,12 @@ Compiler::value NumberSTD::add_mpz_mpz(Compiler& c, std::vector<Compiler::value>
 
 Compiler::value NumberSTD::add_mpz_int(Compiler& c, std::vector<Compiler::value> args, int) {
 	auto r = args[0].t->temporary ? args[0] : c.new_mpz();
-	c.insn_if(c.insn_gt(args[1], c.new_integer(0)), [&]() {
-		c.insn_call(c.env.void_, {r, args[0], args[1]}, "Number.mpz_add_ui");
-	}, [&]() {
-		c.insn_call(c.env.void_, {r, args[0], c.insn_neg(args[1])}, "Number.mpz_sub_ui");
+	c.insn_mpz_small_op(r, args[0], args[1], llvm::Intrinsic::sadd_with_overflow, [&]() {
+		c.insn_if(c.insn_gt(args[1], c.new_integer(0)), [&]() {
+			c.insn_call(c.env.void_, {r, args[0], args[1]}, "Number.mpz_add_ui");
+		}, [&]() {
+			c.insn_call(c.env.void_, {r, args[0], c.insn_neg(args[1])}, "Number.mpz_sub_ui");
+		});
 	});
 	return r;
 }
@@ -637,10 +642,12 @@ Compiler::value NumberSTD::add_eq_mpz_mpz(Compiler& c, std::vector<Compiler::val
 	return flags & NO_RETURN ? Compiler::value { c.env } : c.insn_clone_mpz(args[0]);
 }
 Compiler::value NumberSTD::add_eq_mpz_int(Compiler& c, std::vector<Compiler::value> args, int flags) {
-	c.insn_if(c.insn_gt(args[1], c.new_integer(0)), [&]() {
-		c.insn_call(c.env.void_, {args[0], args[0], args[1]}, "Number.mpz_add_ui");
-	}, [&]() {
-		c.insn_call(c.env.void_, {args[0], args[0], c.insn_neg(args[1])}, "Number.mpz_sub_ui");
+	c.insn_mpz_small_op(args[0], args[0], args[1], llvm::Intrinsic::sadd_with_overflow, [&]() {
+		c.insn_if(c.insn_gt(args[1], c.new_integer(0)), [&]() {
+			c.insn_call(c.env.void_, {args[0], args[0], args[1]}, "Number.mpz_add_ui");
+		}, [&]() {
+			c.insn_call(c.env.void_, {args[0], args[0], c.insn_neg(args[1])}, "Number.mpz_sub_ui");
+		});
 	});
 	return flags & NO_RETURN ? Compiler::value { c.env } : c.insn_clone_mpz(args[0]);
 }
@@ -719,13 +726,17 @@ Compiler::value NumberSTD::mul_real_real(Compiler& c, std::vector<Compiler::valu
 
 Compiler::value NumberSTD::mul_int_mpz(Compiler& c, std::vector<Compiler::value> args, int) {
 	auto r = args[1].t->temporary ? args[1] : c.new_mpz();
-	c.insn_call(c.env.void_, {r, args[1], args[0]}, "Number.mpz_mul_si");
+	c.insn_mpz_small_op(r, args[1], args[0], llvm::Intrinsic::smul_with_overflow, [&]() {
+		c.insn_call(c.env.void_, {r, args[1], args[0]}, "Number.mpz_mul_si");
+	});
 	return r;
 }
 
 Compiler::value NumberSTD::mul_mpz_int(Compiler& c, std::vector<Compiler::value> args, int) {
 	auto r = args[0].t->temporary ? args[0] : c.new_mpz();
-	c.insn_call(c.env.void_, {r, args[0], args[1]}, "Number.mpz_mul_si");
+	c.insn_mpz_small_op(r, args[0], args[1], llvm::Intrinsic::smul_with_overflow, [&]() {
+		c.insn_call(c.env.void_, {r, args[0], args[1]}, "Number.mpz_mul_si");
+	});
 	return r;
 }
 
@@ -754,7 +765,9 @@ Compiler::value NumberSTD::mul_tmp_mpz_mpz(Compiler& c, std::vector<Compiler::va
 Compiler::value NumberSTD::mul_tmp_mpz_int(Compiler& c, std::vector<Compiler::value> args, int) {
 	auto r = c.create_entry("m", c.env.tmp_mpz);
 	c.insn_store(r, args[0]);
-	c.insn_call(c.env.void_, {r, r, args[1]}, "Number.mpz_mul_si");
+	c.insn_mpz_small_op(r, r, args[1], llvm::Intrinsic::smul_with_overflow, [&]() {
+		c.insn_call(c.env.void_, {r, r, args[1]}, "Number.mpz_mul_si");
+	});
 	return r;
 }
 Compiler::value NumberSTD::mul_mpz_tmp_mpz(Compiler& c, std::vector<Compiler::value> args, int) {
@@ -766,7 +779,9 @@ Compiler::value NumberSTD::mul_mpz_tmp_mpz(Compiler& c, std::vector<Compiler::va
 }
 
 Compiler::value NumberSTD::mul_eq_mpz_int(Compiler& c, std::vector<Compiler::value> args, int flags) {
-	c.insn_call(c.env.void_, {args[0], args[0], args[1]}, "Number.mpz_mul_si");
+	c.insn_mpz_small_op(args[0], args[0], args[1], llvm::Intrinsic::smul_with_overflow, [&]() {
+		c.insn_call(c.env.void_, {args[0], args[0], args[1]}, "Number.mpz_mul_si");
+	});
 	if (flags & Module::NO_RETURN) {
 		return { c.env };
 	} else {
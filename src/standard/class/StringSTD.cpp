@@ -53,7 +53,9 @@ LSString* internal_plus_mpz_tmp(VM* vm, LSString* s, __mpz_struct* mpz) {
 	LSString* res = new LSString(*s + buff);
 	LSValue::delete_temporary(s);
 	mpz_clear(mpz);
-	vm->mpz_deleted++;
+	#if DEBUG_LEAKS
+		vm->mpz_deleted++;
+	#endif
 	return res;
 }
 
@@ -260,6 +262,9 @@ StringSTD::StringSTD(Environment& env) : Module(env, "String") {
 	method("isize", {
 		{env.integer, {env.string}, ADDR((void*) LSString::int_size)}
 	}, PRIVATE);
+	method("switch_hash", {
+		{env.integer, {env.string}, ADDR((void*) switch_hash)}
+	}, PRIVATE);
 	method("iterator_begin", {
 		{env.void_, {env.string, env.i8_ptr}, ADDR((void*) iterator_begin)}
 	}, PRIVATE);
@@ -276,6 +281,12 @@ StringSTD::StringSTD(Environment& env) : Module(env, "String") {
 	method("iterator_next", {
 		{env.void_, {env.i8_ptr}, ADDR((void*) &LSString::iterator_next)}
 	}, PRIVATE);
+	method("share", {
+		{env.string, {env.string}, ADDR((void*) LSString::share)}
+	}, PRIVATE);
+	method("unshare", {
+		{env.string, {env.string->pointer()}, ADDR((void*) LSString::unshare)}
+	}, PRIVATE);
 	method("internal_plus_mpz_tmp", {
 		{env.string, {env.i8_ptr, env.tmp_mpz_ptr, env.tmp_string}, ADDR((void*) internal_plus_mpz_tmp)}
 	}, PRIVATE);
@@ -616,6 +627,16 @@ int StringSTD::count(LSString* string, LSString* element) {
 	return count;
 }
 
+/*
+ * Hash of the string dispatched by a `match` on constant strings, and of the constants at compile time
+ */
+int StringSTD::switch_hash(LSString* string) {
+	return switch_hash_constant(*string);
+}
+int StringSTD::switch_hash_constant(const std::string& string) {
+	return (int) std::hash<std::string>{}(string);
+}
+
 #endif
 
 }
@@ -42,6 +42,8 @@ public:
 	static LSMap<int, int>* frequencies(LSString* string);
 	static LSValue* chunk(LSString* string, int size);
 	static int count(LSString* string, LSString* element);
+	static int switch_hash(LSString* string);
+	static int switch_hash_constant(const std::string& string);
 
 	#endif
 };
@@ -167,7 +167,9 @@ void SystemSTD::internal_print_mpz_tmp(VM* vm, __mpz_struct* v) {
 	vm->output->stream() << buff;
 	vm->output->end();
 	mpz_clear(v);
-	vm->mpz_deleted++;
+	#if DEBUG_LEAKS
+		vm->mpz_deleted++;
+	#endif
 }
 
 void SystemSTD::internal_print_long(VM* vm, long v) {
@@ -454,8 +454,8 @@ Compiler::value ValueSTD::op_store(Compiler& c, std::vector<Compiler::value> arg
 	auto x = args[0];
 	auto y = args[1];
 	auto ny = c.insn_convert(y, x.t->pointed());
-	// Move the object
-	ny = c.insn_move_inc(ny);
+	// Move the object, or share the string of another local variable (copy-on-write)
+	ny = (flags & Module::SHARE) ? c.insn_share(ny) : c.insn_move_inc(ny);
 	// Delete previous value
 	if (not (flags & EMPTY_VARIABLE)) {
 		c.insn_delete_variable(x);
@@ -883,6 +883,8 @@ LSValue* ValueSTD::ls_add(LSValue* x, LSValue* y) {
 	return x->add(y);
 }
 LSValue* ValueSTD::ls_add_eq(LSValue** x, LSValue* y) {
+	// A string shared by copy-on-write is copied before the modification
+	if ((*x)->shares) LSString::unshare((LSString**) x);
 	return (*x)->add_eq(y);
 }
 LSValue* ValueSTD::ls_sub(LSValue* x, LSValue* y) {
@@ -1,10 +1,14 @@
 #include "Exception.hpp"
+#include "LSValue.hpp"
 #include "../colors.h"
 
 namespace ls {
 namespace vm {
 
 ExceptionObj::ExceptionObj(Exception type) : type(type) {
+	if (type != NO_EXCEPTION) {
+		LSValue::memory->counters.exceptions++;
+	}
 	// std::cout << "NEW EXCEPTION \t" << (void*) this << std::endl;
 }
 
@@ -47,6 +51,7 @@ std::string ExceptionObj::exception_message(vm::Exception expected) {
 	case vm::Exception::CANT_MODIFY_READONLY_OBJECT: return "cant_modify_readonly_object";
 	case vm::Exception::NO_SUCH_ATTRIBUTE: return "no_such_attribute";
 	case vm::Exception::WRONG_ARGUMENT_TYPE: return "wrong_argument_type";
+	case vm::Exception::MEMORY_LIMIT_EXCEEDED: return "memory_limit_exceeded";
 	}
 	return "??" + std::to_string((int) expected) + "??";
 }
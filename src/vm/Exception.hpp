@@ -23,7 +23,8 @@ enum Exception {
 	ARRAY_KEY_IS_NOT_NUMBER = 6,
 	CANT_MODIFY_READONLY_OBJECT = 7,
 	NO_SUCH_ATTRIBUTE = 8,
-	WRONG_ARGUMENT_TYPE = 9
+	WRONG_ARGUMENT_TYPE = 9,
+	MEMORY_LIMIT_EXCEEDED = 10
 };
 
 struct exception_frame {
@@ -1,5 +1,6 @@
 #include <iostream>
 #include "LSValue.hpp"
+#include "Exception.hpp"
 #include "value/LSNumber.hpp"
 #include "value/LSNull.hpp"
 #include "value/LSBoolean.hpp"
@@ -29,6 +30,21 @@ LSValueType LSValue::LEGACY_ARRAY = 14;
 
 int LSValue::obj_count = 0;
 int LSValue::obj_deleted = 0;
+// Values created outside of an execution (constants, results)
+static thread_local LSValue::Memory outside_memory;
+thread_local LSValue::Memory* LSValue::memory = &outside_memory;
+
+void LSValue::allocated(long bytes) {
+	auto m = memory;
+	m->used += bytes;
+	if (bytes > 0) m->counters.allocated += bytes;
+	if (m->used > m->peak) {
+		m->peak = m->used;
+	}
+	if (bytes > 0 and m->limit > 0 and m->used > m->limit) {
+		m->exceeded = true;
+	}
+}
 
 LSValue::LSValue(LSValueType type, int refs, bool native) : type(type), refs(refs), native(native) {
 	if (not native) {
@@ -47,6 +47,44 @@ public:
 
 	static int obj_count;
 	static int obj_deleted;
+
+	/*
+	 * Instrumentation counters of an execution. The runtime ones (clones,
+	 * reallocations, exceptions, allocated) are always counted (an increment), the boxings and
+	 * the generic calls are counted by the compiled code with Environment::instrumentation.
+	 */
+	struct Counters {
+		long boxings = 0;
+		long generic_calls = 0;
+		long clones = 0;
+		long reallocations = 0;
+		long exceptions = 0;
+		long allocated = 0;
+	};
+	/*
+	 * Memory accounting of the containers (array, string, map, set, object) of an execution:
+	 * live bytes, peak and limit (0 : no limit), and the counters.
+	 * Past the limit the flag is only set: the builtins are called without landing pads,
+	 * the compiled code checks it (like the operations) and throws with its own cleanup.
+	 * Each VM has its own (VM::memory), the one of the thread is the VM executing in it.
+	 */
+	struct Memory {
+		long used = 0;
+		long peak = 0;
+		long limit = 0;
+		bool exceeded = false;
+		Counters counters;
+	};
+	static thread_local Memory* memory;
+	static void allocated(long bytes);
+	static void update_memory(long& accounted, long bytes) {
+		if (bytes != accounted) {
+			auto delta = bytes - accounted;
+			accounted = bytes;
+			allocated(delta);
+		}
+	}
+
 	#if DEBUG_LEAKS
 		static std::unordered_map<void*, LSValue*>& objs() {
 			static std::unordered_map<void*, LSValue*> objs;
@@ -57,6 +95,7 @@ public:
 	LSValueType type;
 	int refs = 0;
 	bool native = false;
+	u_int16_t shares = 0; // copy-on-write: references of local variables sharing the value (in the padding)
 
 	LSValue(LSValueType type, int refs = 0, bool native = false);
 	LSValue(const LSValue& other);
@@ -182,6 +221,7 @@ inline LSValue* LSValue::move() {
 	if (refs == 0) {
 		return this;
 	}
+	memory->counters.clones++;
 	return clone();
 }
 
@@ -193,6 +233,7 @@ inline LSValue* LSValue::move_inc() {
 		refs++;
 		return this;
 	}
+	memory->counters.clones++;
 	auto v = clone();
 	v->refs++;
 	return v;
@@ -1,35 +1,125 @@
 #ifndef OUTPUT_STREAM_HPP
 #define OUTPUT_STREAM_HPP
 
+#include <cstdio>
 #include <iostream>
 #include <ostream>
+#include <sstream>
+#include <string>
 
 namespace ls {
 
+/*
+ * Output of System.print. The lines are not flushed one by one (std::endl): the stream
+ * is flushed at the end of the execution.
+ */
 class OutputStream {
 public:
+	virtual ~OutputStream() {}
 	virtual std::ostream& stream() {
 		return std::cout;
 	}
 	virtual void end() {
-		std::cout << std::endl;
+		std::cout << '\n';
+	}
+	virtual void flush() {
+		std::cout.flush();
+	}
+};
+
+/*
+ * Buffer of a string with a maximum size (0: no limit), the characters after are dropped
+ */
+class BoundedStringBuffer : public std::streambuf {
+public:
+	std::string data;
+	size_t limit;
+	bool truncated = false;
+
+	BoundedStringBuffer(size_t limit) : limit(limit) {}
+
+protected:
+	virtual int_type overflow(int_type c) override {
+		if (c != traits_type::eof()) {
+			char ch = c;
+			xsputn(&ch, 1);
+		}
+		return c;
+	}
+	virtual std::streamsize xsputn(const char* s, std::streamsize n) override {
+		if (limit and data.size() + n > limit) {
+			data.append(s, limit - data.size());
+			truncated = true;
+		} else {
+			data.append(s, n);
+		}
+		return n;
 	}
 };
 
 class OutputStringStream : public ls::OutputStream {
-	std::ostringstream oss;
+	BoundedStringBuffer buffer;
+	std::ostream os;
 public:
+	static constexpr const char* TRUNCATED = "[output truncated]\n";
+
+	OutputStringStream(size_t limit = 0) : buffer(limit), os(&buffer) {}
+
 	virtual std::ostream& stream() override {
-		return oss;
+		return os;
 	}
 	virtual void end() override {
-		oss << std::endl;
+		os << '\n';
+	}
+	virtual void flush() override {}
+	bool truncated() const {
+		return buffer.truncated;
 	}
 	std::string str() const {
-		return oss.str();
+		return buffer.truncated ? buffer.data + TRUNCATED : buffer.data;
+	}
+};
+
+/*
+ * Each printed line is written at once as a JSON line {"print":"..."}, for the consumers
+ * reading the output of a long execution as it comes
+ */
+class OutputJsonLines : public ls::OutputStream {
+	std::ostream& out;
+	std::ostringstream line;
+public:
+	OutputJsonLines(std::ostream& out = std::cout) : out(out) {}
+
+	virtual std::ostream& stream() override {
+		return line;
+	}
+	virtual void end() override {
+		out << "{\"print\":\"";
+		for (unsigned char c : line.str()) {
+			switch (c) {
+				case '"': out << "\\\""; break;
+				case '\\': out << "\\\\"; break;
+				case '\n': out << "\\n"; break;
+				case '\r': out << "\\r"; break;
+				case '\t': out << "\\t"; break;
+				default:
+					if (c < 0x20) {
+						char buff[7];
+						snprintf(buff, sizeof(buff), "\\u%04x", c);
+						out << buff;
+					} else {
+						out << c;
+					}
+			}
+		}
+		out << "\"}\n";
+		line.str("");
+	}
+	virtual void flush() override {
+		out.flush();
 	}
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,245 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <cstdio>
+#include <cstring>
+#include <dlfcn.h>
+#include <mutex>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <cxxabi.h>
+#include "../colors.h"
+
+namespace ls {
+
+thread_local Profiler* Profiler::active = nullptr;
+
+/*
+ * The action of SIGPROF is process-wide: installed by the first profiler started and kept,
+ * a signal still pending after the end of a profile is ignored instead of killing the process
+ */
+static std::once_flag handler_installed;
+
+Profiler::~Profiler() {
+	if (active == this) stop();
+	if (perf_map) fclose(perf_map);
+}
+
+void Profiler::describe(const std::string& symbol, const std::string& description) {
+	descriptions[symbol] = description;
+}
+
+void Profiler::add_symbol(uint64_t module, uint64_t address, uint64_t size, const std::string& name) {
+	symbols[address] = { size, module, name };
+	if (not perf_map) {
+		auto file = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+		perf_map = fopen(file.c_str(), "w");
+	}
+	if (perf_map) {
+		auto d = descriptions.find(name);
+		fprintf(perf_map, "%lx %lx %s\n", (unsigned long) address, (unsigned long) size, (d != descriptions.end() ? d->second : name).c_str());
+		fflush(perf_map);
+	}
+}
+
+void Profiler::remove_symbols(uint64_t module) {
+	for (auto i = symbols.begin(); i != symbols.end();) {
+		if (i->second.module == module) i = symbols.erase(i);
+		else ++i;
+	}
+}
+
+/*
+ * SIGPROF handler: store the interrupted pc and the return addresses found by following
+ * the frame pointers. Only writes in the pre-allocated buffer (async-signal-safe).
+ */
+void Profiler::handler(int, siginfo_t*, void* context) {
+	auto profiler = active;
+	if (!profiler) return;
+	#if defined(__x86_64__) && defined(__linux__)
+		auto uc = (ucontext_t*) context;
+		auto& buffer = profiler->buffer;
+		auto position = profiler->buffer_position.load(std::memory_order_relaxed);
+		if (position + MAX_DEPTH + 1 > buffer.size()) {
+			profiler->lost_samples++;
+			return;
+		}
+		auto depth_position = position++;
+		buffer[position++] = (uintptr_t) uc->uc_mcontext.gregs[REG_RIP];
+		size_t depth = 1;
+		auto low = (uintptr_t) uc->uc_mcontext.gregs[REG_RSP];
+		auto frame = (uintptr_t) uc->uc_mcontext.gregs[REG_RBP];
+		// A frame is valid if it's aligned, above the previous one and inside the stack
+		while (depth < MAX_DEPTH and frame >= low and (frame & 7) == 0 and frame + 16 <= profiler->stack_high) {
+			auto return_address = ((uintptr_t*) frame)[1];
+			if (!return_address) break;
+			buffer[position++] = return_address;
+			depth++;
+			low = frame + 16;
+			frame = ((uintptr_t*) frame)[0];
+		}
+		buffer[depth_position] = depth;
+		profiler->buffer_position.store(position, std::memory_order_release);
+	#else
+		(void) context;
+		profiler->lost_samples++;
+	#endif
+}
+
+void Profiler::install_handler() {
+	std::call_once(handler_installed, []() {
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_sigaction = &Profiler::handler;
+		action.sa_flags = SA_SIGINFO | SA_RESTART;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGPROF, &action, nullptr);
+	});
+}
+
+void Profiler::start() {
+	buffer.assign(BUFFER_SIZE, 0);
+	buffer_position = 0;
+	samples = 0;
+	lost_samples = 0;
+	stacks.clear();
+
+	pthread_attr_t attributes;
+	if (pthread_getattr_np(pthread_self(), &attributes) == 0) {
+		void* address;
+		size_t size;
+		pthread_attr_getstack(&attributes, &address, &size);
+		stack_high = (uintptr_t) address + size;
+		pthread_attr_destroy(&attributes);
+	}
+
+	active = this;
+	install_handler();
+
+	// CPU time of this thread, signal sent to this thread
+	struct sigevent event;
+	memset(&event, 0, sizeof(event));
+	event.sigev_notify = SIGEV_THREAD_ID;
+	event.sigev_signo = SIGPROF;
+	event._sigev_un._tid = syscall(SYS_gettid);
+	if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &timer) != 0) {
+		active = nullptr;
+		return;
+	}
+	struct itimerspec interval;
+	interval.it_interval.tv_sec = 0;
+	interval.it_interval.tv_nsec = INTERVAL_US * 1000;
+	interval.it_value = interval.it_interval;
+	timer_settime(timer, 0, &interval, nullptr);
+}
+
+void Profiler::stop() {
+	if (active != this) return;
+	timer_delete(timer);
+	active = nullptr;
+
+	// Attribute the samples while the JIT'd code is still loaded
+	size_t position = 0;
+	size_t end = buffer_position.load(std::memory_order_acquire);
+	while (position < end) {
+		auto depth = buffer[position++];
+		std::vector<std::string> stack;
+		bool in_jit = false;
+		// From the root to the leaf, skipping the frames before the first JIT'd function (VM, CLI)
+		for (size_t i = depth; i-- > 0;) {
+			bool jit;
+			// Return addresses point after the call instruction
+			auto name = resolve(buffer[position + i] - (i > 0 ? 1 : 0), &jit);
+			in_jit |= jit;
+			if (in_jit) stack.push_back(name);
+		}
+		if (stack.empty()) {
+			stack.push_back(resolve(buffer[position], nullptr));
+		}
+		stacks[stack]++;
+		samples++;
+		position += depth;
+	}
+	buffer.clear();
+	buffer.shrink_to_fit();
+}
+
+std::string Profiler::resolve(uintptr_t pc, bool* jit) const {
+	if (jit) *jit = false;
+	auto s = symbols.upper_bound(pc);
+	if (s != symbols.begin()) {
+		--s;
+		if (pc < s->first + s->second.size) {
+			if (jit) *jit = true;
+			auto d = descriptions.find(s->second.name);
+			return d != descriptions.end() ? d->second : s->second.name;
+		}
+	}
+	Dl_info info;
+	if (dladdr((void*) pc, &info) and info.dli_sname) {
+		int status;
+		auto demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+		std::string name = status == 0 ? demangled : info.dli_sname;
+		free(demangled);
+		// Remove the arguments to keep the lines short
+		auto p = name.find('(');
+		return "[native] " + (p != std::string::npos ? name.substr(0, p) : name);
+	}
+	return "[native]";
+}
+
+static void print_tree(std::ostream& os, const std::map<std::vector<std::string>, long>& stacks, const std::vector<std::string>& prefix, long total, int indent) {
+	// Children of the prefix with their number of samples
+	std::map<std::string, long> children;
+	for (const auto& s : stacks) {
+		if (s.first.size() <= prefix.size() or not std::equal(prefix.begin(), prefix.end(), s.first.begin())) continue;
+		children[s.first[prefix.size()]] += s.second;
+	}
+	std::vector<std::pair<std::string, long>> sorted { children.begin(), children.end() };
+	std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+	for (const auto& child : sorted) {
+		double percent = 100.0 * child.second / total;
+		if (percent < 0.5) continue;
+		os << std::setw(6) << std::fixed << std::setprecision(1) << percent << "%  " << std::string(indent * 2, ' ') << child.first << std::endl;
+		auto next = prefix;
+		next.push_back(child.first);
+		print_tree(os, stacks, next, total, indent + 1);
+	}
+}
+
+void Profiler::print(std::ostream& os) const {
+	os << BOLD << "Profile: " << samples << " samples (" << INTERVAL_US << " µs interval)" << END_STYLE;
+	if (lost_samples) os << C_GREY << " (" << lost_samples << " lost)" << END_COLOR;
+	os << std::endl;
+	if (samples == 0) return;
+
+	// Flat profile: self = leaf of the sample, total = anywhere in the sample (once)
+	std::map<std::string, std::pair<long, long>> functions;
+	for (const auto& s : stacks) {
+		functions[s.first.back()].first += s.second;
+		std::vector<std::string> seen;
+		for (const auto& f : s.first) {
+			if (std::find(seen.begin(), seen.end(), f) != seen.end()) continue;
+			seen.push_back(f);
+			functions[f].second += s.second;
+		}
+	}
+	std::vector<std::pair<std::string, std::pair<long, long>>> flat { functions.begin(), functions.end() };
+	std::sort(flat.begin(), flat.end(), [](const auto& a, const auto& b) {
+		return a.second.first != b.second.first ? a.second.first > b.second.first : a.second.second > b.second.second;
+	});
+	os << std::endl << BOLD << "    self   samples     total  function" << END_STYLE << std::endl;
+	for (const auto& f : flat) {
+		os << std::setw(7) << std::fixed << std::setprecision(1) << (100.0 * f.second.first / samples) << "%"
+			<< std::setw(10) << f.second.first
+			<< std::setw(9) << (100.0 * f.second.second / samples) << "%  "
+			<< f.first << std::endl;
+	}
+
+	os << std::endl << BOLD << "Call tree" << END_STYLE << std::endl;
+	print_tree(os, stacks, {}, samples, 0);
+}
+
+}
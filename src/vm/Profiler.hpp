@@ -0,0 +1,75 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <map>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+#include <signal.h>
+#include <unordered_map>
+
+namespace ls {
+
+/**
+ * Sampling profiler of the JIT'd code (`--profile`)
+ *
+ * The compiled functions are registered when their object is loaded by the JIT (and written
+ * in /tmp/perf-<pid>.map for `perf`), the stack is sampled with SIGPROF during the execution
+ * by walking the frame pointers, and the samples are attributed to the LeekScript functions.
+ * The timer counts the CPU time of the executing thread and signals only this thread, so the
+ * programs executed by the other threads are not sampled nor interrupted.
+ */
+class Profiler {
+
+	struct Symbol {
+		uint64_t size;
+		uint64_t module;
+		std::string name;
+	};
+
+	static thread_local Profiler* active; // of the thread receiving the signal
+	static void handler(int signal, siginfo_t* info, void* context);
+	static void install_handler();
+
+	std::map<uint64_t, Symbol> symbols; // by start address
+	std::unordered_map<std::string, std::string> descriptions; // symbol => "name (file:line)"
+	std::vector<uintptr_t> buffer; // [depth, pc0, pc1, ...] for each sample, leaf first
+	std::atomic<size_t> buffer_position { 0 }; // written by the handler
+	uintptr_t stack_high = 0;
+	FILE* perf_map = nullptr;
+	timer_t timer;
+
+	std::string resolve(uintptr_t pc, bool* jit) const;
+
+public:
+
+	static const int INTERVAL_US = 1000;
+	static const int MAX_DEPTH = 128;
+	static const size_t BUFFER_SIZE = 1 << 22;
+
+	bool enabled = false;
+	long samples = 0;
+	std::atomic<long> lost_samples { 0 };
+	std::map<std::vector<std::string>, long> stacks; // root first
+
+	~Profiler();
+
+	/** Give a readable name to a compiled function */
+	void describe(const std::string& symbol, const std::string& description);
+	/** Register / unregister the functions of a loaded module */
+	void add_symbol(uint64_t module, uint64_t address, uint64_t size, const std::string& name);
+	void remove_symbols(uint64_t module);
+
+	/** Start sampling, stop sampling and attribute the samples */
+	void start();
+	void stop();
+
+	/** Flat profile and call tree */
+	void print(std::ostream& os) const;
+};
+
+}
+
+#endif
@@ -64,6 +64,10 @@ void VM::execute(Program& program, bool format, bool debug, bool ops, bool assem
 	VM::mpz_deleted = 0;
 	VM::operations = 0;
 	VM::enable_operations = ops;
+	memory = {};
+	memory.limit = memory_limit;
+	auto previous_memory = LSValue::memory;
+	LSValue::memory = &memory;
 	Type::placeholder_counter = 0;
 	#if DEBUG_LEAKS
 		LSValue::objs().clear();
@@ -82,6 +86,7 @@ void VM::execute(Program& program, bool format, bool debug, bool ops, bool assem
 	// Execute
 	if (program.result.compilation_success) {
 		std::string value = "";
+		if (profiler.enabled) profiler.start();
 		auto exe_start = std::chrono::high_resolution_clock::now();
 		try {
 			value = program.execute(*this);
@@ -91,6 +96,20 @@ void VM::execute(Program& program, bool format, bool debug, bool ops, bool assem
 			program.result.exception = ex;
 		}
 		auto exe_end = std::chrono::high_resolution_clock::now();
+		// Limit exceeded after the last check of the compiled code
+		if (memory.exceeded and program.result.execution_success) {
+			program.result.execution_success = false;
+			program.result.exception = vm::ExceptionObj(vm::Exception::MEMORY_LIMIT_EXCEEDED);
+			value = "";
+		}
+		memory.limit = 0;
+		memory.exceeded = false;
+		if (profiler.enabled) {
+			profiler.stop();
+			std::ostringstream oss;
+			profiler.print(oss);
+			program.result.profile = oss.str();
+		}
 
 		auto execution_time = std::chrono::duration_cast<std::chrono::nanoseconds>(exe_end - exe_start).count();
 		program.result.execution_time = (((double) execution_time / 1000) / 1000);
@@ -100,6 +119,16 @@ void VM::execute(Program& program, bool format, bool debug, bool ops, bool assem
 
 	// Set results
 	program.result.operations = VM::operations;
+	program.result.memory_peak = memory.peak;
+	if (env.instrumentation) {
+		program.result.instrumented = true;
+		program.result.boxings = memory.counters.boxings;
+		program.result.generic_calls = memory.counters.generic_calls;
+		program.result.clones = memory.counters.clones;
+		program.result.reallocations = memory.counters.reallocations;
+		program.result.exceptions = memory.counters.exceptions;
+		program.result.allocated_bytes = memory.counters.allocated;
+	}
 
 	// Cleaning
 	for (const auto& f : function_created) {
@@ -134,9 +163,13 @@ void VM::execute(Program& program, bool format, bool debug, bool ops, bool assem
 		#endif
 		// LCOV_EXCL_STOP
 	}
-	if (VM::mpz_deleted != VM::mpz_created) {
-		std::cout << C_RED << "/!\\ " << VM::mpz_deleted << " / " << VM::mpz_created << " (" << (VM::mpz_created - VM::mpz_deleted) << " mpz leaked)" << END_COLOR << std::endl; // LCOV_EXCL_LINE
-	}
+	// The mpz are only counted in the leak-checking builds
+	#if DEBUG_LEAKS
+		if (VM::mpz_deleted != VM::mpz_created) {
+			std::cout << C_RED << "/!\\ " << VM::mpz_deleted << " / " << VM::mpz_created << " (" << (VM::mpz_created - VM::mpz_deleted) << " mpz leaked)" << END_COLOR << std::endl; // LCOV_EXCL_LINE
+		}
+	#endif
+	LSValue::memory = previous_memory;
 }
 #endif
 
@@ -157,7 +190,8 @@ void* VM::resolve_symbol(std::string name) {
 		// std::cout << "method = " << method << std::endl;
 		// std::cout << "version = " << version << std::endl;
 		if (module == "ctx") {
-			return &context->vars.at(method).value;
+			auto ctx = h != std::string::npos ? batch_contexts.at(version) : context;
+			return &ctx->vars.at(method).value;
 		} else if (std.classes.find(module) != std.classes.end()) {
 			const auto& clazz = std.classes.at(module)->clazz;
 			if (method.substr(0, 8) == "operator") {
@@ -14,6 +14,7 @@
 #include "../compiler/Compiler.hpp"
 #include "Exception.hpp"
 #include "OutputStream.hpp"
+#include "Profiler.hpp"
 #include "../analyzer/semantic/Call.hpp"
 
 #define OPERATION_LIMIT 10000000
@@ -51,12 +52,16 @@ public:
 	unsigned int operations = 0;
 	bool enable_operations = true;
 	unsigned int operation_limit;
+	long memory_limit = 0; // bytes, 0 : no limit
+	LSValue::Memory memory; // accounting of the execution (LSValue::memory while executing)
 	OutputStream* output = default_output;
 	long mpz_created = 0;
 	long mpz_deleted = 0;
 	std::string file_name;
 	bool legacy;
 	Context* context = nullptr;
+	std::vector<Context*> batch_contexts; // of the programs of a batch being linked, symbols ctx.<name>.<i>
+	Profiler profiler;
 
 	VM(Environment& env, StandardLibrary& std);
 	~VM();
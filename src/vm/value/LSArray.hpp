@@ -14,6 +14,8 @@ template <typename T>
 class LSArray : public LSValue, public std::vector<T> {
 public:
 
+	long accounted_memory = 0; // bytes counted in LSValue::memory
+
 	static LSArray<T>* constructor(int);
 
 	LSArray();
@@ -24,6 +26,8 @@ public:
 
 	virtual ~LSArray();
 
+	void update_memory();
+
 	/*
 	 * Array functions
 	 */
@@ -18,6 +18,7 @@ template <class T>
 LSArray<T>* LSArray<T>::constructor(int capacity) {
 	auto array = new LSArray<T>();
 	array->reserve(capacity);
+	array->update_memory();
 	return array;
 }
 
@@ -26,36 +27,55 @@ inline LSArray<LSValue*>::~LSArray() {
 	for (auto v : *this) {
 		LSValue::delete_ref(v);
 	}
+	LSValue::allocated(-accounted_memory);
 }
 template <typename T>
-LSArray<T>::~LSArray() {}
+LSArray<T>::~LSArray() {
+	LSValue::allocated(-accounted_memory);
+}
+
+template <class T>
+inline void LSArray<T>::update_memory() {
+	long bytes = sizeof(LSArray<T>) + this->capacity() * sizeof(T);
+	// The buffer was moved to a bigger one
+	if (bytes > accounted_memory and accounted_memory > (long) sizeof(LSArray<T>)) {
+		LSValue::memory->counters.reallocations++;
+	}
+	LSValue::update_memory(accounted_memory, bytes);
+}
 
 template <>
 inline void LSArray<LSValue*>::push_clone(LSValue* value) {
 	this->push_back(value->clone_inc());
+	update_memory();
 }
 template <typename T>
 void LSArray<T>::push_clone(T value) {
 	this->push_back(value);
+	update_memory();
 }
 
 template <>
 inline void LSArray<LSValue*>::push_move(LSValue* value) {
 	this->push_back(value->move_inc());
+	update_memory();
 }
 template <typename T>
 void LSArray<T>::push_move(T value) {
 	this->push_back(value);
+	update_memory();
 }
 
 template <>
 inline void LSArray<LSValue*>::push_inc(LSValue* value) {
 	if (!value->native) value->refs++;
 	this->push_back(value);
+	update_memory();
 }
 template <class T>
 inline void LSArray<T>::push_inc(T value) {
 	this->push_back(value);
+	update_memory();
 }
 template <class T>
 void LSArray<T>::std_push_inc(LSArray<T>* array, T value) {
@@ -70,14 +90,18 @@ LSArray<T>::LSArray(std::initializer_list<T> values_list) : LSArray<T>() {
 	for (auto i : values_list) {
 		this->push_back(i);
 	}
+	update_memory();
 }
 
 template <class T>
-LSArray<T>::LSArray(const std::vector<T>& vec) : LSValue(LSValue::ARRAY), std::vector<T>(vec) {}
+LSArray<T>::LSArray(const std::vector<T>& vec) : LSValue(LSValue::ARRAY), std::vector<T>(vec) {
+	update_memory();
+}
 
 template <class T>
 LSArray<T>::LSArray(size_t size) : LSValue(LSValue::ARRAY) {
 	this->reserve(size);
+	update_memory();
 }
 
 template <>
@@ -86,9 +110,11 @@ inline LSArray<LSValue*>::LSArray(const LSArray<LSValue*>& other) : LSValue(othe
 	for (LSValue* v : other) {
 		push_back(v->clone_inc());
 	}
+	update_memory();
 }
 template <typename T>
 inline LSArray<T>::LSArray(const LSArray<T>& other) : LSValue(other), std::vector<T>(other) {
+	update_memory();
 }
 
 template <typename T>
@@ -450,12 +476,14 @@ bool LSArray<T>::ls_contains(LSArray<T>* array, T val) {
 template <>
 inline LSArray<LSValue*>* LSArray<LSValue*>::ls_push(LSArray<LSValue*>* array, LSValue* val) {
 	array->push_back(val->move_inc());
+	array->update_memory();
 	return array;
 }
 
 template <class T>
 LSArray<T>* LSArray<T>::ls_push(LSArray<T>* array, T val) {
 	array->push_back(val);
+	array->update_memory();
 	return array;
 }
 
@@ -468,6 +496,7 @@ inline LSArray<LSValue*>* LSArray<LSValue*>::ls_push_all_ptr(LSArray<LSValue*>*
 		}
 		array->clear();
 		delete array;
+		array1->update_memory();
 	} else {
 		for (auto v : *array) {
 			array1->push_clone(v);
@@ -497,6 +526,7 @@ inline LSArray<T>* LSArray<T>::ls_push_all_int(LSArray<T>* array1, LSArray<int>*
 	array1->reserve(array1->size() + array->size());
 	array1->insert(array1->end(), array->begin(), array->end());
 	if (array->refs == 0) delete array;
+	array1->update_memory();
 	return array1;
 }
 
@@ -515,6 +545,7 @@ inline LSArray<T>* LSArray<T>::ls_push_all_flo(LSArray<T>* array1, LSArray<doubl
 	array1->reserve(array1->size() + array->size());
 	array1->insert(array1->end(), array->begin(), array->end());
 	if (array->refs == 0) delete array;
+	array1->update_memory();
 	return array1;
 }
 
@@ -628,16 +659,20 @@ inline LSArray<T>* LSArray<T>::ls_reverse(LSArray<T>* array) {
 template <class T>
 template <class F>
 LSArray<T>* LSArray<T>::ls_filter(LSArray<T>* array, F function) {
-	if (refs == 0) {
-		for (size_t i = 0; i < array->size(); ) {
-			T v = (*array)[i];
-			if (!ls::call<bool>(function, v)) {
-				ls::unref(v);
-				this->erase(array->begin() + i);
-			} else {
-				++i;
+	if (array->refs == 0) {
+		// Compact in place: one pass instead of an erase per removed element. The rejected
+		// elements are swapped to the tail and only released at the end: if the function
+		// throws, the array still holds each element once and is deleted normally
+		size_t kept = 0;
+		for (size_t i = 0; i < array->size(); ++i) {
+			if (ls::call<bool>(function, (*array)[i])) {
+				std::swap((*array)[kept++], (*array)[i]);
 			}
 		}
+		for (size_t i = kept; i < array->size(); ++i) {
+			ls::unref((*array)[i]);
+		}
+		array->resize(kept);
 		return array;
 	} else {
 		auto new_array = new LSArray<T>();
@@ -677,6 +712,7 @@ inline LSArray<LSValue*>* LSArray<LSValue*>::ls_insert(LSArray<LSValue*>* array,
 		array->resize(pos, LSNull::get());
 	}
 	array->insert(array->begin() + pos, value->move_inc());
+	array->update_memory();
 	return array;
 }
 
@@ -686,6 +722,7 @@ LSArray<T>* LSArray<T>::ls_insert(LSArray<T>* array, T value, int pos) {
 		array->resize(pos, (T) 0);
 	}
 	array->insert(array->begin() + pos, value);
+	array->update_memory();
 	return array;
 }
 
@@ -818,6 +855,7 @@ template <typename T>
 inline LSArray<T>* LSArray<T>::ls_fill(LSArray<T>* array, T element, int size) {
 	array->clear();
 	array->resize(size, element);
+	array->update_memory();
 	return array;
 }
 
@@ -991,6 +1029,7 @@ LSValue* LSArray<T>::add_set(LSSet<T2>* set) {
 			this->push_clone(ls::convert<T>(v));
 		}
 	}
+	update_memory();
 	return this;
 }
 
@@ -1018,10 +1057,12 @@ inline LSValue* LSArray<LSValue*>::add(LSValue* v) {
 	}
 	if (refs == 0) {
 		this->push_move(v);
+		update_memory();
 		return this;
 	}
 	auto r = (LSArray<LSValue*>*) this->clone();
 	r->push_move(v);
+	r->update_memory();
 	return r;
 }
 
@@ -1045,16 +1086,19 @@ inline LSValue* LSArray<double>::add(LSValue* v) {
 			}
 		}
 		if (refs == 0) delete this;
+		ret->update_memory();
 		return ret;
 	} else if (auto number = dynamic_cast<LSNumber*>(v)) {
 		if (refs == 0) {
 			this->push_back(number->value);
 			if (number->refs == 0) delete v;
+			update_memory();
 			return this;
 		}
 		auto r = (LSArray<double>*) this->clone();
 		r->push_back(number->value);
 		if (number->refs == 0) delete number;
+		r->update_memory();
 		return r;
 	} else {
 		auto r = new LSArray<LSValue*>();
@@ -1064,6 +1108,7 @@ inline LSValue* LSArray<double>::add(LSValue* v) {
 		}
 		r->push_move(v);
 		if (refs == 0) delete this;
+		r->update_memory();
 		return r;
 	}
 }
@@ -1089,6 +1134,7 @@ inline LSValue* LSArray<int>::add(LSValue* v) {
 				}
 			}
 			if (refs == 0) delete this;
+			ret->update_memory();
 			return ret;
 		}
 		if (auto array = dynamic_cast<LSArray<int>*>(v)) {
@@ -1104,6 +1150,7 @@ inline LSValue* LSArray<int>::add(LSValue* v) {
 			ret->insert(ret->end(), array->begin(), array->end());
 			if (refs == 0) delete this;
 			if (array->refs == 0) delete array;
+			ret->update_memory();
 			return ret;
 		}
 	}
@@ -1112,11 +1159,13 @@ inline LSValue* LSArray<int>::add(LSValue* v) {
 			if (refs == 0) {
 				this->push_back(number->value);
 				if (number->refs == 0) delete number;
+				update_memory();
 				return this;
 			}
 			auto r = (LSArray<int>*) this->clone();
 			r->push_back(number->value);
 			if (number->refs == 0) delete number;
+			r->update_memory();
 			return r;
 		}
 		auto ret = new LSArray<double>();
@@ -1124,6 +1173,7 @@ inline LSValue* LSArray<int>::add(LSValue* v) {
 		ret->push_back(number->value);
 		if (refs == 0) delete this;
 		if (number->refs == 0) delete number;
+		ret->update_memory();
 		return ret;
 	} else {
 		auto r = new LSArray<LSValue*>();
@@ -1133,6 +1183,7 @@ inline LSValue* LSArray<int>::add(LSValue* v) {
 		}
 		r->push_move(v);
 		if (refs == 0) delete this;
+		r->update_memory();
 		return r;
 	}
 }
@@ -1159,6 +1210,7 @@ inline LSValue* LSArray<long>::add(LSValue* v) {
 				}
 			}
 			if (refs == 0) delete this;
+			ret->update_memory();
 			return ret;
 		}
 		if (auto array = dynamic_cast<LSArray<int>*>(v)) {
@@ -1174,6 +1226,7 @@ inline LSValue* LSArray<long>::add(LSValue* v) {
 			ret->insert(ret->end(), array->begin(), array->end());
 			if (refs == 0) delete this;
 			if (array->refs == 0) delete array;
+			ret->update_memory();
 			return ret;
 		}
 	}
@@ -1182,11 +1235,13 @@ inline LSValue* LSArray<long>::add(LSValue* v) {
 			if (refs == 0) {
 				this->push_back(number->value);
 				if (number->refs == 0) delete number;
+				update_memory();
 				return this;
 			}
 			auto r = (LSArray<int>*) this->clone();
 			r->push_back(number->value);
 			if (number->refs == 0) delete number;
+			r->update_memory();
 			return r;
 		}
 		auto ret = new LSArray<double>();
@@ -1194,6 +1249,7 @@ inline LSValue* LSArray<long>::add(LSValue* v) {
 		ret->push_back(number->value);
 		if (refs == 0) delete this;
 		if (number->refs == 0) delete number;
+		ret->update_memory();
 		return ret;
 	} else {
 		auto r = new LSArray<LSValue*>();
@@ -1203,6 +1259,7 @@ inline LSValue* LSArray<long>::add(LSValue* v) {
 		}
 		r->push_move(v);
 		if (refs == 0) delete this;
+		r->update_memory();
 		return r;
 	}
 }
@@ -1228,6 +1285,7 @@ inline LSValue* LSArray<char>::add(LSValue* v) {
 				}
 			}
 			if (refs == 0) delete this;
+			ret->update_memory();
 			return ret;
 		}
 		if (auto array = dynamic_cast<LSArray<int>*>(v)) {
@@ -1243,6 +1301,7 @@ inline LSValue* LSArray<char>::add(LSValue* v) {
 			ret->insert(ret->end(), array->begin(), array->end());
 			if (refs == 0) delete this;
 			if (array->refs == 0) delete array;
+			ret->update_memory();
 			return ret;
 		}
 	}
@@ -1251,11 +1310,13 @@ inline LSValue* LSArray<char>::add(LSValue* v) {
 			if (refs == 0) {
 				this->push_back(number->value);
 				if (number->refs == 0) delete number;
+				update_memory();
 				return this;
 			}
 			auto r = (LSArray<int>*) this->clone();
 			r->push_back(number->value);
 			if (number->refs == 0) delete number;
+			r->update_memory();
 			return r;
 		}
 		auto ret = new LSArray<double>();
@@ -1263,6 +1324,7 @@ inline LSValue* LSArray<char>::add(LSValue* v) {
 		ret->push_back(number->value);
 		if (refs == 0) delete this;
 		if (number->refs == 0) delete number;
+		ret->update_memory();
 		return ret;
 	} else {
 		auto r = new LSArray<LSValue*>();
@@ -1272,6 +1334,7 @@ inline LSValue* LSArray<char>::add(LSValue* v) {
 		}
 		r->push_move(v);
 		if (refs == 0) delete this;
+		r->update_memory();
 		return r;
 	}
 }
@@ -1301,6 +1364,7 @@ inline LSValue* LSArray<LSValue*>::add_eq(LSValue* v) {
 		}
 	}
 	push_move(v);
+	update_memory();
 	return this;
 }
 
@@ -1320,6 +1384,7 @@ inline LSValue* LSArray<double>::add_eq(LSValue* v) {
 	if (auto number = dynamic_cast<LSNumber*>(v)) {
 		this->push_back(number->value);
 		LSValue::delete_temporary(number);
+		update_memory();
 		return this;
 	}
 	auto set = dynamic_cast<LSSet<int>*>(v);
@@ -1331,12 +1396,14 @@ inline LSValue* LSArray<int>::add_eq(LSValue* v) {
 	if (auto number = dynamic_cast<LSNumber*>(v)) {
 		this->push_back(number->value);
 		LSValue::delete_temporary(number);
+		update_memory();
 		return this;
 	}
 	if (auto array = dynamic_cast<LSArray<int>*>(v)) {
 		this->reserve(this->size() + array->size());
 		this->insert(this->end(), array->begin(), array->end());
 		LSValue::delete_temporary(v);
+		update_memory();
 		return this;
 	}
 	auto set = dynamic_cast<LSSet<int>*>(v);
@@ -1349,12 +1416,14 @@ inline LSValue* LSArray<long>::add_eq(LSValue* v) {
 	if (auto number = dynamic_cast<LSNumber*>(v)) {
 		this->push_back(number->value);
 		LSValue::delete_temporary(number);
+		update_memory();
 		return this;
 	}
 	if (auto array = dynamic_cast<LSArray<int>*>(v)) {
 		this->reserve(this->size() + array->size());
 		this->insert(this->end(), array->begin(), array->end());
 		LSValue::delete_temporary(v);
+		update_memory();
 		return this;
 	}
 	auto set = dynamic_cast<LSSet<int>*>(v);
@@ -1366,16 +1435,19 @@ inline LSValue* LSArray<char>::add_eq(LSValue* v) {
 	if (auto number = dynamic_cast<LSNumber*>(v)) {
 		this->push_back(number->value);
 		LSValue::delete_temporary(number);
+		update_memory();
 		return this;
 	}
 	if (auto array = dynamic_cast<LSArray<char>*>(v)) {
 		this->reserve(this->size() + array->size());
 		this->insert(this->end(), array->begin(), array->end());
 		LSValue::delete_temporary(v);
+		update_memory();
 		return this;
 	}
 	// auto set = dynamic_cast<LSSet<int>*>(v);
 	// return add_set(set);
+	update_memory();
 	return this;
 }
 
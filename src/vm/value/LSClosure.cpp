@@ -1,3 +1,4 @@
+#include <cassert>
 #include "LSClosure.hpp"
 #include "LSNull.hpp"
 #include "LSClass.hpp"
@@ -8,18 +9,22 @@
 
 namespace ls {
 
-LSClosure* LSClosure::constructor(VM* vm, void* f) {
-	auto c = new LSClosure(f);
+const size_t LSClosure::CAPTURES_OFFSET = sizeof(LSClosure);
+
+LSClosure* LSClosure::constructor(VM* vm, void* f, int captures) {
+	auto c = new (captures) LSClosure(f, captures);
 	vm->function_created.push_back(c);
 	return c;
 }
 
-LSClosure::LSClosure(void* function) : LSFunction(function) {
+LSClosure::LSClosure(void* function, int captures) : LSFunction(function), captures_capacity(captures) {
 	type = CLOSURE;
+	this->captures = (LSValue**) ((char*) this + CAPTURES_OFFSET);
+	this->captures_native = (bool*) (this->captures + captures);
 }
 
 LSClosure::~LSClosure() {
-	for (size_t i = 0; i < captures.size(); ++i) {
+	for (int i = 0; i < captures_size; ++i) {
 		if (!captures_native[i] and captures[i] != this) {
 			LSValue::delete_ref(captures[i]);
 		}
@@ -30,12 +35,24 @@ bool LSClosure::closure() const {
 	return true;
 }
 
+void* LSClosure::operator new(size_t size, int captures) {
+	return ::operator new(size + captures * (sizeof(LSValue*) + sizeof(bool)));
+}
+void LSClosure::operator delete(void* p) {
+	::operator delete(p);
+}
+void LSClosure::operator delete(void* p, int) {
+	::operator delete(p);
+}
+
 void LSClosure::add_capture(LSClosure* closure, LSValue* value) {
 	if (!value->native && value != closure) {
 		value->refs++;
 	}
-	closure->captures.push_back(value);
-	closure->captures_native.push_back(value->native);
+	assert(closure->captures_size < closure->captures_capacity);
+	closure->captures[closure->captures_size] = value;
+	closure->captures_native[closure->captures_size] = value->native;
+	closure->captures_size++;
 }
 
 LSValue* LSClosure::get_capture(LSClosure* closure, int index) {
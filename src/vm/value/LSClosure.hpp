@@ -11,18 +11,34 @@
 
 namespace ls {
 
+/**
+ * Closure: a function with its captured values
+ *
+ * The captures are stored in a single allocation, right after the object
+ * ([LSClosure][captures: LSValue* x n][native: bool x n]), so the compiled
+ * code reaches a capture at a constant offset, without any call.
+ */
 class LSClosure : public LSFunction {
 public:
 
-	static LSClosure* constructor(VM* vm, void* f);
+	/* Offset of the first capture from the closure address, used by the generated code */
+	static const size_t CAPTURES_OFFSET;
 
-	std::vector<LSValue*> captures;
-	std::vector<bool> captures_native; // TODO check if necessary
+	static LSClosure* constructor(VM* vm, void* f, int captures);
 
-	LSClosure(void* function);
+	LSValue** captures;
+	bool* captures_native;
+	int captures_size = 0;
+	int captures_capacity;
+
+	LSClosure(void* function, int captures);
 	virtual ~LSClosure();
 	virtual bool closure() const;
 
+	void* operator new(size_t size, int captures);
+	void operator delete(void* p);
+	void operator delete(void* p, int captures);
+
 	static void add_capture(LSClosure* closure, LSValue* value);
 	static LSValue* get_capture(LSClosure* closure, int index);
 	static LSValue** get_capture_l(LSClosure* closure, int index);
@@ -39,7 +39,7 @@ LSArray<int>* LSInterval::std_filter(LSInterval* interval, LSClosure* function)
 }
 
 long LSInterval::std_sum(LSInterval* interval) {
-	auto sum = (interval->b - interval->a + 1) * (interval->a + interval->b) / 2;
+	auto sum = ((long) interval->b - interval->a + 1) * ((long) interval->a + interval->b) / 2;
 	LSValue::delete_temporary(interval);
 	return sum;
 }
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include "LSLegacyArray.hpp"
 #include "../VM.hpp"
 #include "LSNull.hpp"
@@ -8,31 +10,38 @@
 
 namespace ls {
 
-LSValue* Element::keyValue() {
-	if (key->isInteger())
-		return LSNumber::get(key->getInteger());
+LSValue* Element::keyValue() const {
+	if (key.isInteger())
+		return LSNumber::get(key.getInteger());
 	else
-		return new LSString(key->getString());
+		return new LSString(key.getString());
 }
 
-int KeyComparator::compare(Element* v1, Element* v2) const {
+int KeyComparator::compare(const Element& v1, const Element& v2) const {
 	if (mOrder == SORT_ASC)
-		return compare(v1->key, v2->key);
+		return compare(v1.key, v2.key);
 	else if (mOrder == SORT_DESC)
-		return compare(v2->key, v1->key);
+		return compare(v2.key, v1.key);
 	return 0;
 }
 
-int KeyComparator::compare(Key* v1, Key* v2) const {
-	if (v1->isString() && v2->isString())
-		return v1->getString() < v2->getString();
-	else if (v1->isInteger() && v2->isInteger())
-		return v1->getInteger() < v2->getInteger();
-	else if (v1->isInteger())
+int KeyComparator::compare(const Key& v1, const Key& v2) const {
+	if (v1.isString() && v2.isString())
+		return v1.getString() < v2.getString();
+	else if (v1.isInteger() && v2.isInteger())
+		return v1.getInteger() < v2.getInteger();
+	else if (v1.isInteger())
 		return -1;
 	return 1;
 }
 
+/*
+ * Position d'un hash dans la table (hachage de Fibonacci, la table a 2^bits cases)
+ */
+static inline size_t slot_of(size_t hash, int bits) {
+	return (hash * 11400714819323198485ull) >> (64 - bits);
+}
+
 const int LSLegacyArray::MAX_CAPACITY = 32000;
 
 LSLegacyArray::LSLegacyArray(VM* vm) : LSValue(INTERVAL), vm(vm) {}
@@ -44,11 +53,11 @@ LSLegacyArray::LSLegacyArray(VM* vm, int capacity) : LSValue(INTERVAL), vm(vm) {
 LSLegacyArray::LSLegacyArray(VM* vm, LSLegacyArray* phpArray) : LSValue(INTERVAL), vm(vm) {
 	if (phpArray->size() > 0) {
 		initTable(phpArray->size());
-		auto e = phpArray->mHead;
-		while (e != nullptr) {
-			set(e->key, e->value->clone());
-			e = e->next;
-		}
+		phpArray->forEach([&](const Key& key, LSValue* value) {
+			Key k = key;
+			set(&k, value->clone());
+			return true;
+		});
 	}
 }
 LSLegacyArray::~LSLegacyArray() {}
@@ -56,7 +65,9 @@ LSLegacyArray::~LSLegacyArray() {}
 void LSLegacyArray::initTable(int capacity) {
 	vm->add_operations(capacity / 5);
 	this->capacity = capacity;
-	mTable.resize(capacity, nullptr);
+	if (mPacked) {
+		mValues.reserve(capacity);
+	}
 }
 
 void LSLegacyArray::growCapacity() {
@@ -65,23 +76,22 @@ void LSLegacyArray::growCapacity() {
 
 	capacity = std::min(capacity * 2, MAX_CAPACITY);
 
-	// Copy in a new array
-	auto newArray = new LSLegacyArray(vm, capacity);
-	auto e = mHead;
-	while (e != nullptr) {
-		newArray->set(e->key, e->value);
-		e = e->next;
+	// L'ancienne table était reconstruite en réinsérant chaque élément dans un
+	// nouveau tableau : on facture les mêmes opérations
+	vm->add_operations(capacity / 5);
+	for (int i = 0; i < mSize; ++i) {
+		vm->add_operations(ARRAY_CELL_ACCESS_OPERATIONS);
+		vm->add_operations(ARRAY_CELL_CREATE_OPERATIONS + (int) std::sqrt(i) / 3);
+	}
+	// Et l'index suivant était recalculé à partir des clés existantes
+	if (not mPacked) {
+		mIndex = 0;
+		for (const auto& e : mElements) {
+			if (e.value != nullptr and e.numeric and e.key.getInteger() >= mIndex) {
+				mIndex = e.key.getInteger() + 1;
+			}
+		}
 	}
-	// Use the table of this new array
-	mTable = newArray->mTable;
-	mHead = newArray->mHead;
-	mEnd = newArray->mEnd;
-	mSize = newArray->mSize;
-	mIndex = newArray->mIndex;
-}
-
-Element* LSLegacyArray::getHeadElement() {
-	return mHead;
 }
 
 int LSLegacyArray::size() {
@@ -89,117 +99,108 @@ int LSLegacyArray::size() {
 }
 
 LSValue* LSLegacyArray::get(Key* key) {
-	auto e = getElement(key);
-	return e == nullptr ? LSNull::get() : e->value;
+	auto v = findValue(*key);
+	return v == nullptr ? LSNull::get() : *v;
 }
 
 LSValue* LSLegacyArray::get(int key) {
-	return get(new Key(key));
+	Key k { key };
+	return get(&k);
 }
 LSValue* LSLegacyArray::get(std::string key) {
-	return get(new Key(key));
+	Key k { key };
+	return get(&k);
 }
 
 bool LSLegacyArray::containsKey(Key* key) {
-	return getElement(key) != nullptr;
+	return findValue(*key) != nullptr;
 }
 
 bool LSLegacyArray::contains(LSValue* value) {
-	auto e = mHead;
-	while (e != nullptr) {
-		if (*e->value == *value)
-			return true;
-		e = e->next;
-	}
-	return false;
+	bool found = false;
+	forEach([&](const Key&, LSValue* v) {
+		found = *v == *value;
+		return not found;
+	});
+	return found;
 }
 
 LSValue* LSLegacyArray::search(LSValue* value, int pos) {
-	auto e = mHead;
 	int p = 0;
-	while (e != nullptr) {
-		if (p >= pos && e->value->type == value->type && *e->value == *value) {
-			if (e->key->isInteger())
-				return LSNumber::get(e->key->getInteger());
+	LSValue* result = nullptr;
+	forEach([&](const Key& key, LSValue* v) {
+		if (p >= pos && v->type == value->type && *v == *value) {
+			if (key.isInteger())
+				result = LSNumber::get(key.getInteger());
 			else
-				return new LSString(e->key->getString());
+				result = new LSString(key.getString());
+			return false;
 		}
-		e = e->next;
 		p++;
-	}
-	return LSNull::get();
+		return true;
+	});
+	return result == nullptr ? LSNull::get() : result;
 }
 
 LSValue* LSLegacyArray::removeIndex(int index) {
-	if (index >= mSize)
+	if (index >= mSize or index < 0)
 		return LSNull::get();
-	auto e = mHead;
-	int p = 0;
-	while (e != nullptr) {
-		if (p == index) {
-			remove(e->key);
-			reindex();
-			return e->value;
-		}
-		e = e->next;
-		p++;
-	}
-	return LSNull::get();
+	chargeAccess();
+	if (mPacked) {
+		auto value = mValues[index];
+		mValues.erase(mValues.begin() + index);
+		mSize--;
+		mIndex = mSize;
+		return value;
+	}
+	// Position comptée sans les trous
+	int position = 0;
+	for (int p = 0; position < (int) mElements.size(); ++position) {
+		if (mElements[position].value != nullptr and p++ == index) break;
+	}
+	auto value = mElements[position].value;
+	eraseElement(position);
+	reindex();
+	return value;
 }
 
 void LSLegacyArray::remove(Key* key) {
-	auto e = getElement(key);
-	if (e == nullptr)
+	if (findValue(*key) == nullptr)
 		return;
-
-	destroyElement(e);
-	// Si l'élément existe on l'enleve de la hashmap
-	removeFromHashmap(e);
-	// Puis on refait le chainage sans l'élément
-	if (e->prev == nullptr)
-		mHead = e->next;
-	else
-		e->prev->next = e->next;
-
-	if (e->next == nullptr)
-		mEnd = e->prev;
-	else
-		e->next->prev = e->prev;
+	unpack();
+	eraseElement(mSlots[findSlot(*key, key->hashCode())]);
 }
 
 void LSLegacyArray::sort(int comparator) {
 	if (mSize == 0) {
 		return;
 	}
-	// création de la liste
-	std::vector<Element*> liste;
-	auto elem = mHead;
-	while (elem != nullptr) {
-		liste.push_back(elem);
-		elem = elem->next;
+	bool by_key = comparator == ASC_K || comparator == DESC_K;
+	bool keep_keys = comparator == ASC_A || comparator == DESC_A || by_key;
+	// Les tris qui conservent les clés cassent la séquence 0..n-1
+	if (keep_keys and mSize > 1) {
+		unpack();
 	}
+	auto order = (comparator == ASC || comparator == ASC_A) ? ElementComparator::SORT_ASC : ElementComparator::SORT_DESC;
+	if (mPacked) {
+		if (comparator != RANDOM and not by_key) {
+			std::sort(mValues.begin(), mValues.end(), ElementComparator(order));
+		}
+		return;
+	}
+	compact();
 	// Trie de la liste
 	if (comparator == RANDOM) {
 		// Collections.shuffle(liste);
-	} else if (comparator == ASC_K || comparator == DESC_K) {
-		std::sort(liste.begin(), liste.end(), KeyComparator(comparator == ASC_K ? ElementComparator::SORT_ASC : ElementComparator::SORT_DESC));
+	} else if (by_key) {
+		std::sort(mElements.begin(), mElements.end(), KeyComparator(comparator == ASC_K ? KeyComparator::SORT_ASC : KeyComparator::SORT_DESC));
 	} else {
-		std::sort(liste.begin(), liste.end(), ElementComparator((comparator == ASC || comparator == ASC_A) ? ElementComparator::SORT_ASC : ElementComparator::SORT_DESC));
-	}
-	// Mise en place de la liste
-	mHead = liste.at(0);
-	Element* prev = nullptr;
-	for (int i = 0; i < liste.size(); i++) {
-		auto cur = liste.at(i);
-		if (prev != nullptr)
-			prev->next = cur;
-		cur->prev = prev;
-		prev = cur;
-	}
-	prev->next = nullptr;
-	mEnd = prev;
+		std::sort(mElements.begin(), mElements.end(), ElementComparator(order));
+	}
 	if (comparator == ASC || comparator == RANDOM || comparator == DESC) {
 		reindex();
+	} else {
+		rebuildTable();
 	}
 }
 
@@ -207,43 +208,20 @@ void LSLegacyArray::sort(ElementComparator comparator) {
 	if (mSize == 0) {
 		return;
 	}
-	auto e = mHead;
-	bool isInOrder = true;
-	int value = 0;
-	while (e != nullptr) {
-		if (!e->key->isInteger() || e->key->getInteger() != value) {
-			isInOrder = false;
-			break;
-		}
-		value++;
-		e = e->next;
-	}
-
-	// création de la liste
-	std::vector<Element*> liste;
-	auto elem = mHead;
-	while (elem != nullptr) {
-		liste.push_back(elem);
-		elem = elem->next;
+	if (mPacked) {
+		std::sort(mValues.begin(), mValues.end(), comparator);
+		return;
 	}
+	bool isInOrder = not isAssociative();
 
 	// Tri de la liste
-	std::sort(liste.begin(), liste.end(), comparator);
-
-	// Mise en place de la liste
-	mHead = liste.at(0);
-	Element* prev = nullptr;
-	for (int i = 0; i < liste.size(); i++) {
-		auto cur = liste.at(i);
-		if (prev != nullptr)
-			prev->next = cur;
-		cur->prev = prev;
-		prev = cur;
-	}
-	prev->next = nullptr;
-	mEnd = prev;
+	compact();
+	std::sort(mElements.begin(), mElements.end(), comparator);
+
 	if (isInOrder) {
 		reindex();
+	} else {
+		rebuildTable();
 	}
 }
 
@@ -251,24 +229,12 @@ void LSLegacyArray::reverse() {
 	if (mSize == 0) {
 		return;
 	}
-	Element* prev = nullptr;
-	auto current = mEnd;
-	Element* tmp;
-	while (current != nullptr) {
-		// Fin de liste
-		if (prev == nullptr) {
-			mHead = current;
-		} else {
-			prev->next = current;
-		}
-		tmp = prev;
-		prev = current;
-		current = current->prev;
-		prev->prev = tmp;
+	if (mPacked) {
+		std::reverse(mValues.begin(), mValues.end());
+		return;
 	}
-	prev->next = nullptr;
-	mEnd = prev;
-
+	compact();
+	std::reverse(mElements.begin(), mElements.end());
 	reindex();
 }
 
@@ -276,109 +242,104 @@ void LSLegacyArray::assocReverse() {
 	if (mSize == 0) {
 		return;
 	}
-	Element* prev = nullptr;
-	auto current = mEnd;
-	Element* tmp;
-	while (current != nullptr) {
-		// Fin de liste
-		if (prev == nullptr) {
-			mHead = current;
-		} else {
-			prev->next = current;
-		}
-		tmp = prev;
-		prev = current;
-		current = current->prev;
-		prev->prev = tmp;
+	if (mSize > 1) {
+		unpack();
 	}
-	prev->next = nullptr;
-	mEnd = prev;
+	if (mPacked) {
+		return;
+	}
+	compact();
+	std::reverse(mElements.begin(), mElements.end());
+	rebuildTable();
 }
 
 void LSLegacyArray::removeObject(LSValue* value) {
-	auto e = mHead;
-	while (e != nullptr) {
-		if (e->value->type == value->type && *e->value == *value) {
-			// On a notre élément à supprimer
-			// On l'enleve de la HashMap
-			removeFromHashmap(e);
-			destroyElement(e);
-			// Puis on refait le chainage sans l'élément
-			if (e->prev == nullptr)
-				mHead = e->next;
-			else
-				e->prev->next = e->next;
-
-			if (e->next == nullptr)
-				mEnd = e->prev;
-			else
-				e->next->prev = e->prev;
+	if (mPacked) {
+		for (size_t i = 0; i < mValues.size(); ++i) {
+			if (mValues[i]->type == value->type && *mValues[i] == *value) {
+				unpack();
+				eraseElement(i);
+				return;
+			}
+		}
+		return;
+	}
+	for (size_t i = 0; i < mElements.size(); ++i) {
+		auto v = mElements[i].value;
+		if (v != nullptr && v->type == value->type && *v == *value) {
+			eraseElement(i);
 			return;
 		}
-		e = e->next;
 	}
 }
 
 void LSLegacyArray::push(LSValue* value) {
-	auto key = new Key(mIndex);
-	auto e = createElement(key, value);
-	pushElement(e);
-	mSize++;
-	if (mSize > capacity) {
-		growCapacity();
-	}
+	chargeCreate();
+	appendElement(Key(mIndex), value);
+	added();
 }
 
 void LSLegacyArray::unshift(LSValue* value) {
-	auto key = new Key(0);
-	auto e = createElement(key, value);
-	unshiftElement(e);
-	reindex();
-	mSize++;
-	if (mSize > capacity) {
-		growCapacity();
+	chargeCreate();
+	if (mPacked) {
+		mValues.insert(mValues.begin(), value);
+		mIndex++;
+	} else {
+		compact();
+		mElements.insert(mElements.begin(), Element(Key(0), value));
+		reindex();
 	}
+	added();
 }
 
 void LSLegacyArray::set(Key* key, LSValue* value) {
-	auto e = getElement(key);
+	auto v = findValue(*key);
 	// Si l'élément n'existe pas on le crée
-	if (e == nullptr) {
-		e = createElement(key, value);
-		pushElement(e);
-		mSize++;
-		if (mSize > capacity) {
-			growCapacity();
-		}
+	if (v == nullptr) {
+		chargeCreate();
+		appendElement(*key, value);
+		added();
 	} else {
-		e->value = value;
+		*v = value;
 	}
 }
 
 LSValue* LSLegacyArray::getOrCreate(Key* key) {
-	auto e = getElement(key);
-	if (e == nullptr) {
-		e = createElement(key, LSNull::get());
-		pushElement(e);
-		mSize++;
-		if (mSize > capacity) {
-			growCapacity();
-			e = getElement(key);
+	auto v = findValue(*key);
+	if (v == nullptr) {
+		chargeCreate();
+		appendElement(*key, LSNull::get());
+		if (added()) {
+			// L'élément était recherché à nouveau après l'agrandissement
+			chargeAccess();
 		}
+		return LSNull::get();
 	}
-	return e->value;
+	return *v;
 }
 
 void LSLegacyArray::set(int key, LSValue* value) {
-	set(new Key(key), value);
+	Key k { key };
+	set(&k, value);
 }
 
 LSValue* LSLegacyArray::end() {
-	return mEnd == nullptr ? LSNull::get() : mEnd->value;
+	if (mPacked) {
+		return mValues.empty() ? LSNull::get() : mValues.back();
+	}
+	for (auto e = mElements.rbegin(); e != mElements.rend(); ++e) {
+		if (e->value != nullptr) return e->value;
+	}
+	return LSNull::get();
 }
 
 LSValue* LSLegacyArray::start() {
-	return mHead == nullptr ? LSNull::get() : mHead->value;
+	LSValue* first = LSNull::get();
+	forEach([&](const Key&, LSValue* v) {
+		first = v;
+		return false;
+	});
+	return first;
 }
 
 void LSLegacyArray::insert(int position, LSValue* value) {
@@ -389,26 +350,18 @@ void LSLegacyArray::insert(int position, LSValue* value) {
 	} else if (position == 0) {
 		unshift(value);
 	} else {
-		// On crée notre nouvel élément
-		auto e = createElement(new Key(mIndex), value);
-		// On va rechercher l'élément avant lequel insérer
-		auto i = mHead;
-		for (int k = 0; k < position; k++)
-			i = i->next;
-
-		// On insert l'élément (normalement ça n'est ni la tête ni la queue)
-		e->prev = i->prev;
-		e->next = i;
-		i->prev->next = e;
-		i->prev = e;
-
-		// On réindexe
-		reindex();
-
-		mSize++;
-		if (mSize > capacity) {
-			growCapacity();
+		chargeCreate();
+		if (mPacked) {
+			mValues.insert(mValues.begin() + position, value);
+			mIndex++;
+		} else {
+			// On insère notre nouvel élément avant l'élément à la position donnée
+			compact();
+			mElements.insert(mElements.begin() + position, Element(Key(mIndex), value));
+			// On réindexe
+			reindex();
 		}
+		added();
 	}
 }
 
@@ -417,157 +370,191 @@ void LSLegacyArray::insert(int position, LSValue* value) {
 void LSLegacyArray::reindex() {
 	// Réindexer le tableau (Change l'index de toutes les valeurs
 	// numériques)
+	if (mPacked) {
+		mIndex = mValues.size();
+		return;
+	}
+	compact();
 	int new_index = 0;
-
-	auto e = mHead;
-	while (e != nullptr) {
-		if (e->numeric) {
-			auto new_key = new Key(new_index);
+	for (auto& e : mElements) {
+		if (e.numeric) {
 			// Changement de clé
-			if (*e->key != *new_key) {
-				// On regarde si le hashCode change
-				if (new_key->hashCode() != e->hash) {
-					removeFromHashmap(e);
-					e->hash = new_key->hashCode();
-					addToHashMap(e);
-				}
-				e->key = new_key;
+			if (e.key.getInteger() != new_index) {
+				e.key = Key(new_index);
+				e.hash = e.key.hashCode();
 			}
 			new_index++;
 		}
-		e = e->next;
 	}
 	mIndex = new_index;
+	// Que des clés numériques : on revient à une liste packée
+	if (new_index == (int) mElements.size()) {
+		pack();
+	} else {
+		rebuildTable();
+	}
 }
 
-void LSLegacyArray::unshiftElement(Element* e) {// Ajouter un élément au début
-	if (mHead == nullptr) { // Tableau vide
-		mHead = e;
-		mEnd = e;
-	} else { // Ajouter au début
-		mHead->prev = e;
-		e->next = mHead;
-		mHead = e;
-	}
+bool LSLegacyArray::isPacked() const {
+	return mPacked;
 }
 
-void LSLegacyArray::pushElement(Element* e) {// Ajouter un élément à la fin
-	if (mEnd == nullptr) { // Tableau vide
-		mHead = e;
-		mEnd = e;
-	} else { // Sinon on ajoute à la fin
-		mEnd->next = e;
-		e->prev = mEnd;
-		mEnd = e;
+void LSLegacyArray::pack() {
+	mValues.clear();
+	mValues.reserve(mElements.size());
+	for (const auto& e : mElements) {
+		mValues.push_back(e.value);
 	}
+	mElements.clear();
+	mSlots.clear();
+	mSlotBits = 0;
+	mUsedSlots = 0;
+	mPacked = true;
 }
 
-Element* LSLegacyArray::createElement(Key* key, LSValue* value) {
-	// On crée l'élément
-	auto e = new Element();
-	e->hash = key->hashCode();
-	e->key = key;
-
-	// On ajoute la taille de la clé
-	// int keySize = 1;
-
-	e->value = value;
-	if (key->isInteger()) {
-		// On met à jour l'index suivant
-		int index = key->getInteger();
-		if (index >= mIndex)
-			mIndex = index + 1;
-		e->numeric = true;
+void LSLegacyArray::unpack() {
+	if (not mPacked) {
+		return;
+	}
+	mElements.clear();
+	mElements.reserve(mValues.size());
+	for (size_t i = 0; i < mValues.size(); ++i) {
+		mElements.emplace_back(Key((int) i), mValues[i]);
 	}
+	mValues.clear();
+	mValues.shrink_to_fit();
+	mPacked = false;
+	rebuildTable();
+}
 
-	// On l'ajoute dans la hashmap
-	addToHashMap(e);
+void LSLegacyArray::compact() {
+	if (mPacked or (int) mElements.size() == mSize) {
+		return;
+	}
+	mElements.erase(std::remove_if(mElements.begin(), mElements.end(), [](const Element& e) {
+		return e.value == nullptr;
+	}), mElements.end());
+	mSlots.clear();
+}
+
+void LSLegacyArray::rebuildTable() {
+	compact();
+	int bits = 3;
+	while ((size_t(1) << bits) < mElements.size() * 2) {
+		bits++;
+	}
+	mSlotBits = bits;
+	mSlots.assign(size_t(1) << bits, EMPTY_SLOT);
+	mUsedSlots = 0;
+	size_t mask = mSlots.size() - 1;
+	for (size_t p = 0; p < mElements.size(); ++p) {
+		auto i = slot_of(mElements[p].hash, mSlotBits);
+		while (mSlots[i] != EMPTY_SLOT) {
+			i = (i + 1) & mask;
+		}
+		mSlots[i] = p;
+		mUsedSlots++;
+	}
+}
 
+void LSLegacyArray::chargeCreate() {
+	if (capacity == 0) {
+		initTable(START_CAPACITY);
+	}
 	int operations = ARRAY_CELL_CREATE_OPERATIONS + (int) std::sqrt(mSize) / 3;
 	vm->add_operations(operations);
-
-	return e;
 }
 
-void LSLegacyArray::addToHashMap(Element* e) {
-	if (not mTable.size()) {
-		initTable(START_CAPACITY);
+void LSLegacyArray::chargeAccess() {
+	if (capacity == 0) {
+		return; // empty array
 	}
-	// Ajouter dans la hashmap
-	int index = getIndex(e->hash);
-	auto f = mTable[index];
-	if (f == nullptr)
-		mTable[index] = e;
-	else {
-		while (f->hashNext != nullptr) {
-			f = f->hashNext;
-		}
-		f->hashNext = e;
+	int operations = ARRAY_CELL_ACCESS_OPERATIONS;
+	vm->add_operations(operations);
+}
+
+bool LSLegacyArray::added() {
+	mSize++;
+	if (mSize > capacity) {
+		growCapacity();
+		return true;
 	}
+	return false;
 }
 
-void LSLegacyArray::removeFromHashmap(Element* e) {
-	if (not mTable.size()) {
-		return; // nothing to to, empty array
+LSValue** LSLegacyArray::findValue(const Key& key) {
+	if (capacity == 0) {
+		return nullptr; // empty array
 	}
-	// Remove from hash hashmap
-	int index = getIndex(e->hash);
-	auto f = mTable[index];
-	if (f == nullptr)
-		return;
-	else if (f == e) {
-		mTable[index] = e->hashNext;
-		e->hashNext = nullptr;
-	} else {
-		while (f->hashNext != e && f->hashNext != nullptr) {
-			f = f->hashNext;
+	chargeAccess();
+	if (mPacked) {
+		if (key.isInteger() and key.getInteger() >= 0 and key.getInteger() < (int) mValues.size()) {
+			return &mValues[key.getInteger()];
 		}
-		if (f->hashNext == nullptr) {
+		return nullptr;
+	}
+	int slot = findSlot(key, key.hashCode());
+	return slot == -1 ? nullptr : &mElements[mSlots[slot]].value;
+}
+
+void LSLegacyArray::appendElement(const Key& key, LSValue* value) {
+	if (mPacked) {
+		// La séquence 0..n-1 continue
+		if (key.isInteger() and key.getInteger() == mIndex) {
+			mValues.push_back(value);
+			mIndex++;
 			return;
 		}
-		f->hashNext = f->hashNext->hashNext;
-		e->hashNext = nullptr;
+		unpack();
+	}
+	if (key.isInteger()) {
+		// On met à jour l'index suivant
+		int index = key.getInteger();
+		if (index >= mIndex)
+			mIndex = index + 1;
 	}
+	mElements.emplace_back(key, value);
+	insertSlot(mElements.back().hash, mElements.size() - 1);
 }
 
-void LSLegacyArray::destroyElement(Element* e) {
+void LSLegacyArray::eraseElement(int position) {
+	auto& e = mElements[position];
+	mSlots[findSlot(e.key, e.hash)] = DELETED_SLOT;
+	e.value = nullptr;
 	mSize--;
-	/*
-	Limite de RAM
-	if (e->key->isInteger())
-		e->value->removeFromTable(1);
-	else
-		e->value->removeFromTable(((String) e->key).length());
-	*/
 }
 
-Element* LSLegacyArray::getElement(Key* key) {
-	if (not mTable.size()) {
-		return nullptr; // empty array
+int LSLegacyArray::findSlot(const Key& key, size_t hash) const {
+	if (mSlots.empty()) {
+		return -1;
 	}
-	int operations = ARRAY_CELL_ACCESS_OPERATIONS;
-	vm->add_operations(operations);
-
-	int hash = getHash(key);
-	int index = getIndex(hash);
-
-	auto f = mTable[index];
-
-	while (f != nullptr) {
-		if (f->hash == hash && *f->key == *key) {
-			return f;
+	size_t mask = mSlots.size() - 1;
+	auto i = slot_of(hash, mSlotBits);
+	while (mSlots[i] != EMPTY_SLOT) {
+		int p = mSlots[i];
+		if (p >= 0 and mElements[p].hash == hash and mElements[p].key == key) {
+			return i;
 		}
-		f = f->hashNext;
+		i = (i + 1) & mask;
 	}
-	return nullptr;
-}
-
-int LSLegacyArray::getHash(Key* key) {
-	return key->hashCode();
+	return -1;
 }
 
-int LSLegacyArray::getIndex(int hash) {
-	return hash & (capacity - 1);
+void LSLegacyArray::insertSlot(size_t hash, int position) {
+	// Table pleine aux 3/4 (en comptant les cases supprimées) : on la reconstruit
+	if ((mUsedSlots + 1) * 4 > (int) mSlots.size() * 3) {
+		rebuildTable();
+		return;
+	}
+	size_t mask = mSlots.size() - 1;
+	auto i = slot_of(hash, mSlotBits);
+	while (mSlots[i] >= 0) {
+		i = (i + 1) & mask;
+	}
+	if (mSlots[i] == EMPTY_SLOT) {
+		mUsedSlots++;
+	}
+	mSlots[i] = position;
 }
 
 std::string LSLegacyArray::toString() const {
@@ -576,50 +563,44 @@ std::string LSLegacyArray::toString() const {
 
 	std::string sb;
 	// On va regarder si le tableau est dans l'ordre
-	auto e = mHead;
-
-	bool isInOrder = true;
-	int value = 0;
-	while (e != nullptr) {
-		if (!e->key->isInteger() || e->key->getInteger() != value) {
-			isInOrder = false;
-			break;
-		}
-		value++;
-		e = e->next;
-	}
+	bool isInOrder = not isAssociative();
 
 	sb.append("[");
-	e = mHead;
-	while (e != nullptr) {
-		if (e != mHead)
+	bool first = true;
+	forEach([&](const Key& key, LSValue* value) {
+		if (!first)
 			sb.append(", ");
+		first = false;
 		if (!isInOrder) {
-			if (e->key->isInteger()) {
-				sb.append(std::to_string(e->key->getInteger()));
+			if (key.isInteger()) {
+				sb.append(std::to_string(key.getInteger()));
 			 } else {
-				sb.append('\'' + e->key->getString() + '\'');
+				sb.append('\'' + key.getString() + '\'');
 			 }
 			sb.append(" => ");
 		}
-		sb.append(e->value->to_string());
-		e = e->next;
-	}
+		sb.append(value->to_string());
+		return true;
+	});
 	sb.append("]");
 	return sb;
 }
 
-bool LSLegacyArray::isAssociative() {
-	auto e = mHead;
+bool LSLegacyArray::isAssociative() const {
+	if (mPacked) {
+		return false;
+	}
 	int value = 0;
-	while (e != nullptr) {
-		if (!e->key->isInteger() || e->key->getInteger() != value) {
-			return true;
+	bool associative = false;
+	forEach([&](const Key& key, LSValue*) {
+		if (!key.isInteger() || key.getInteger() != value) {
+			associative = true;
+			return false;
 		}
 		value++;
-		e = e->next;
-	}
-	return false;
+		return true;
+	});
+	return associative;
 }
 
 bool LSLegacyArray::equals(LSLegacyArray* array) {
@@ -634,18 +615,21 @@ bool LSLegacyArray::equals(LSLegacyArray* array) {
 
 	vm->add_operations(mSize);
 
-	auto e1 = mHead;
-	auto e2 = array->mHead;
 	// On va comparer chaque élément 1 à 1
-	while (e1 != nullptr) {
-		if (*e1->key != *e2->key)
-			return false;
-		if (*e1->value != *e2->value)
-			return false;
-		e1 = e1->next;
-		e2 = e2->next;
-	}
-	return true;
+	std::vector<std::pair<Key, LSValue*>> elements;
+	elements.reserve(mSize);
+	forEach([&](const Key& key, LSValue* value) {
+		elements.push_back({ key, value });
+		return true;
+	});
+	size_t i = 0;
+	bool equal = true;
+	array->forEach([&](const Key& key, LSValue* value) {
+		const auto& e = elements[i++];
+		equal = e.first == key && *e.second == *value;
+		return equal;
+	});
+	return equal;
 }
 
 void LSLegacyArray::setParent(LSValue* parent) {
@@ -3,6 +3,7 @@
 
 #include "../LSValue.hpp"
 #include <functional>
+#include <vector>
 
 namespace ls {
 
@@ -14,18 +15,19 @@ class Key {
     int integer;
     std::string string;
 public:
+    Key() : _is_integer(true), integer(0) {}
     Key(int integer) : _is_integer(true), integer(integer) {}
-    Key(std::string s) : _is_integer(false), string(s) {}
-    bool isInteger() {
+    Key(std::string s) : _is_integer(false), integer(0), string(s) {}
+    bool isInteger() const {
         return _is_integer;
     }
-    bool isString() {
+    bool isString() const {
         return not _is_integer;
     }
-    int getInteger() {
+    int getInteger() const {
         return integer;
     }
-    std::string getString() {
+    const std::string& getString() const {
         return string;
     }
     bool operator == (const Key& key) const {
@@ -34,35 +36,29 @@ public:
     bool operator != (const Key& key) const {
         return not operator == (key);
     }
-    size_t hashCode() {
+    size_t hashCode() const {
         return _is_integer ? std::hash<int>{}(integer) : std::hash<std::string>{}(string);
     }
 };
 
+/**
+ * Cellule d'un tableau associatif : la clé est stockée directement dans la cellule.
+ * Une cellule supprimée (trou) a une valeur nulle.
+ */
 class Element {
 public:
-    Key* key;
-    int hash;
+    Key key;
+    size_t hash = 0;
     bool numeric = false;
     LSValue* value = nullptr;
-    Element* next = nullptr;
-    Element* prev = nullptr;
-    Element* hashNext = nullptr;
 
-    LSValue* keyValue();
-    void setValue(LSValue* v) {
-        value = v;
-    }
-};
+    Element() {}
+    Element(Key key, LSValue* value) : key(key), hash(key.hashCode()), numeric(key.isInteger()), value(value) {}
 
-template <typename T>
-class Comparator {
-public:
-    virtual int compare(T, T) const = 0;
-    bool operator() (T i, T j) { return compare(i, j); }
+    LSValue* keyValue() const;
 };
 
-class ElementComparator : public Comparator<Element*> {
+class ElementComparator {
 public:
     static const int SORT_ASC = 1;
     static const int SORT_DESC = 2;
@@ -71,16 +67,18 @@ public:
 
     ElementComparator(int order) : mOrder(order) {}
 
-    int compare(Element* v1, Element* v2) const override {
+    int compare(const LSValue* v1, const LSValue* v2) const {
         if (mOrder == SORT_ASC)
-            return *v1->value < *v2->value;
+            return *v1 < *v2;
         else if (mOrder == SORT_DESC)
-            return *v2->value < *v1->value;
+            return *v2 < *v1;
         return 0;
     }
+    bool operator() (const Element& e1, const Element& e2) const { return compare(e1.value, e2.value); }
+    bool operator() (const LSValue* v1, const LSValue* v2) const { return compare(v1, v2); }
 };
 
-class KeyComparator : public Comparator<Element*> {
+class KeyComparator {
 public:
     static const int SORT_ASC = 1;
     static const int SORT_DESC = 2;
@@ -89,42 +87,25 @@ public:
 
     KeyComparator(int order) : mOrder(order) {}
 
-    int compare(Element* v1, Element* v2) const override;
-    int compare(Key* v1, Key* v2) const;
-};
-
-class PhpIterator {
-    Element* e = nullptr;
-public:
-    PhpIterator(Element* head) : e(head) {}
-    bool hasNext() {
-        return e != nullptr;
-    }
-    LSValue* next() {
-        auto v = e->value;
-        if (e != nullptr)
-            e = e->next;
-        return v;
-    }
-    void remove() {}
-};
-
-class ReversedPhpIterator {
-    Element* e = nullptr;
-public:
-    ReversedPhpIterator(Element* end) : e(end) {}
-    bool hasNext() {
-        return e != nullptr;
-    }
-    LSValue* next() {
-        auto v = e->value;
-        if (e != nullptr)
-            e = e->prev;
-        return v;
-    }
-    void remove() {}
+    int compare(const Element& v1, const Element& v2) const;
+    int compare(const Key& v1, const Key& v2) const;
+    bool operator() (const Element& e1, const Element& e2) const { return compare(e1, e2); }
 };
 
+/**
+ * Tableau "PHP" des IA legacy : clés entières ou chaînes, ordre d'insertion conservé.
+ *
+ * Deux représentations :
+ * - liste "packée" : les clés sont exactement 0..n-1 dans l'ordre, seules les valeurs
+ *   sont stockées, de façon contiguë, et l'accès par clé est direct.
+ * - table de hachage ordonnée : les cellules sont stockées dans l'ordre dans un vecteur
+ *   (avec des trous après une suppression) et une table à adressage ouvert (sondage
+ *   linéaire) contient les positions des cellules.
+ * Le passage en mode hachage se fait à la première clé qui casse la séquence.
+ *
+ * La capacité logique (`capacity`) et le décompte des opérations reproduisent exactement
+ * ceux de l'ancienne table chaînée, indépendamment de la taille réelle de la table.
+ */
 class LSLegacyArray : public LSValue {
 private:
 	static const int START_CAPACITY = 16;
@@ -132,10 +113,10 @@ private:
     static const int ARRAY_CELL_CREATE_OPERATIONS = 2;
     static const int ARRAY_CELL_ACCESS_OPERATIONS = 2;
 	static const int RAM_LIMIT = 1000000;
+	static const int EMPTY_SLOT = -1;
+	static const int DELETED_SLOT = -2;
 
     VM* vm;
-	Element* mHead = nullptr;
-	Element* mEnd = nullptr;
 
 	int mIndex = 0;
 	int mSize = 0;
@@ -145,7 +126,15 @@ private:
 	int mTotalSize = 0;
 	LSValue* mParent = nullptr;
 
-	std::vector<Element*> mTable;
+	// Mode liste packée
+	bool mPacked = true;
+	std::vector<LSValue*> mValues;
+
+	// Mode table de hachage
+	std::vector<Element> mElements;
+	std::vector<int> mSlots;
+	int mSlotBits = 0;
+	int mUsedSlots = 0; // cellules + cellules supprimées
 
 public:
 
@@ -164,7 +153,6 @@ public:
 
 	void initTable(int capacity);
 	void growCapacity();
-	Element* getHeadElement();
 
 	/**
 	 * Retourne le nombre d'éléments dans le tableau
@@ -271,7 +259,7 @@ public:
 	 * Mettre à jour la valeur pour une clé donnée
 	 *
 	 * @param key
-	 *            Clé (Integer, Double ou String)
+	 *            Clé (Integer, Double ou String), copiée dans le tableau
 	 * @param value
 	 *            Valeur
 	 */
@@ -291,27 +279,35 @@ public:
 
 	void reindex();
 
-	void unshiftElement(Element* e);
+	bool isPacked() const;
+
+	void pack();
+
+	void unpack();
 
-	void pushElement(Element* e);
+	void compact();
 
-	Element* createElement(Key* key, LSValue* value);
+	void rebuildTable();
 
-	void addToHashMap(Element* e);
+	void chargeCreate();
 
-	void removeFromHashmap(Element* e);
+	void chargeAccess();
 
-	void destroyElement(Element* e);
+	bool added();
 
-	Element* getElement(Key* key);
+	LSValue** findValue(const Key& key);
 
-	int getHash(Key* key);
+	void appendElement(const Key& key, LSValue* value);
 
-	int getIndex(int hash);
+	void eraseElement(int position);
+
+	int findSlot(const Key& key, size_t hash) const;
+
+	void insertSlot(size_t hash, int position);
 
 	std::string toString() const;
 
-	bool isAssociative();
+	bool isAssociative() const;
 
 	bool equals(LSLegacyArray* array);
 
@@ -321,6 +317,23 @@ public:
 
 	int getSize();
 
+	/**
+	 * Parcours des éléments dans l'ordre du tableau (clé, valeur)
+	 */
+	template <class F>
+	void forEach(F f) const {
+		if (mPacked) {
+			for (size_t i = 0; i < mValues.size(); ++i) {
+				if (not f(Key((int) i), mValues[i])) return;
+			}
+		} else {
+			for (const auto& e : mElements) {
+				if (e.value == nullptr) continue;
+				if (not f(e.key, e.value)) return;
+			}
+		}
+	}
+
     virtual bool to_bool() const override;
 	virtual bool ls_not() const override;
 	virtual bool eq(const LSValue*) const override;
@@ -338,4 +351,4 @@ public:
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -2,6 +2,7 @@
 #define LS_MAP_BASE
 
 #include "../LSValue.hpp"
+#include "NodeAllocator.hpp"
 #include <map>
 
 namespace ls {
@@ -12,13 +13,20 @@ struct lsmap_less {
 };
 
 template <typename K, typename V>
-class LSMap : public LSValue, public std::map<K, V, lsmap_less<K>> {
+using lsmap_base = std::map<K, V, lsmap_less<K>, NodeAllocator<std::pair<const K, V>>>;
+
+template <typename K, typename V>
+class LSMap : public LSValue, public lsmap_base<K, V> {
 public:
+	long accounted_memory = 0; // bytes counted in LSValue::memory
+
 	static LSMap<K, V>* constructor();
 
 	LSMap();
 	virtual ~LSMap();
 
+	void update_memory();
+
 	/*
 	 * Map methods;
 	 */
@@ -48,6 +48,13 @@ LSMap<K, V>::~LSMap() {
 		ls::unref(it->first);
 		ls::unref(it->second);
 	}
+	LSValue::allocated(-accounted_memory);
+}
+
+template <class K, class V>
+inline void LSMap<K, V>::update_memory() {
+	// Red-black tree node : color, parent, left, right and the pair
+	LSValue::update_memory(accounted_memory, sizeof(LSMap<K, V>) + this->size() * (4 * sizeof(void*) + sizeof(std::pair<K, V>)));
 }
 
 /*
@@ -65,6 +72,7 @@ bool LSMap<K, V>::std_insert(LSMap<K, V>* map, K key, V value) {
 	auto it = map->lower_bound(key);
 	if (it == map->end() || !ls::equals(it->first, key)) {
 		map->emplace_hint(it, ls::move_inc(key), ls::move_inc(value));
+		map->update_memory();
 		if (map->refs == 0) delete map;
 		return true;
 	}
@@ -79,6 +87,7 @@ void LSMap<K, V>::std_emplace(LSMap<K, V>* map, K key, V value) {
 	auto it = map->lower_bound(key);
 	if (it == map->end() || !ls::equals(it->first, key)) {
 		map->emplace_hint(it, ls::move_inc(key), ls::move_inc(value));
+		map->update_memory();
 	} else {
 		ls::release(key);
 		ls::release(value);
@@ -92,6 +101,7 @@ LSMap<K, V>* LSMap<K, V>::std_clear(LSMap<K, V>* map) {
 		ls::unref(it->second);
 	}
 	map->clear();
+	map->update_memory();
 	return map;
 }
 
@@ -103,6 +113,7 @@ bool LSMap<K, V>::std_erase(LSMap<K, V>* map, K key) {
 		ls::unref(it->first);
 		ls::unref(it->second);
 		map->erase(it);
+		map->update_memory();
 		LSValue::delete_temporary(map);
 		return true;
 	}
@@ -350,7 +361,7 @@ template <class K, class V>
 V LSMap<K, V>::at_k(const K key) const {
 	bool ex = false;
 	try {
-		auto map = (std::map<K, V, lsmap_less<K>>*) this;
+		auto map = (lsmap_base<K, V>*) this;
 		return map->at(key);
 	} catch (std::exception&) {
 		ex = true;
@@ -364,7 +375,7 @@ template <class K, class V>
 LSValue* LSMap<K, V>::at(const LSValue* key) const {
 	bool ex = false;
 	try {
-		auto map = (std::map<K, V, lsmap_less<K>>*) this;
+		auto map = (lsmap_base<K, V>*) this;
 		return ls::convert<LSValue*>(map->at(ls::convert<K>(key)));
 	} catch (std::exception&) {
 		ex = true;
@@ -415,7 +426,7 @@ inline LSValue** LSMap<double, LSValue*>::atL(const LSValue* key) {
 template <class K, class T>
 inline T* LSMap<K, T>::atL_base(LSMap<K, T>* raw_map, K key) {
 	// std::cout << "atL_base " << key << std::endl;
-	auto map = (std::map<K, T, lsmap_less<K>>*) raw_map;
+	auto map = (lsmap_base<K, T>*) raw_map;
 	try {
 		auto r = &map->at(key);
 		ls::release(key);
@@ -423,6 +434,7 @@ inline T* LSMap<K, T>::atL_base(LSMap<K, T>* raw_map, K key) {
 	} catch (std::exception&) {
 		auto k = ls::move_inc(key);
 		auto r = map->insert({k, ls::construct<T>()});
+		raw_map->update_memory();
 		return &r.first->second;
 	}
 }
@@ -462,6 +474,7 @@ LSValue* LSMap<K, V>::clone() const {
 	for (auto it = this->begin(); it != this->end(); ++it) {
 		map->emplace(ls::clone_inc(it->first), ls::clone_inc(it->second));
 	}
+	map->update_memory();
 	return map;
 }
 
@@ -24,7 +24,9 @@ LSMpz* LSMpz::get_from_tmp(VM* vm, __mpz_struct i) {
 LSMpz* LSMpz::get(VM* vm) {
 	auto mpz = new LSMpz(vm);
 	mpz_init(&mpz->value);
-	vm->mpz_created++;
+	#if DEBUG_LEAKS
+		vm->mpz_created++;
+	#endif
 	return mpz;
 }
 LSMpz* LSMpz::get(VM* vm, long i) {
@@ -37,16 +39,22 @@ LSMpz::LSMpz(VM* vm) : LSValue(MPZ), vm(vm) {
 
 LSMpz::LSMpz(VM* vm, __mpz_struct value) : LSValue(MPZ), vm(vm) {
 	mpz_init_set(&this->value, &value);
-	vm->mpz_created++;
+	#if DEBUG_LEAKS
+		vm->mpz_created++;
+	#endif
 }
 LSMpz::LSMpz(VM* vm, long l) : LSValue(MPZ), vm(vm) {
 	mpz_init_set_si(&value, l);
-	vm->mpz_created++;
+	#if DEBUG_LEAKS
+		vm->mpz_created++;
+	#endif
 }
 
 LSMpz::~LSMpz() {
 	mpz_clear(&value);
-	vm->mpz_deleted++;
+	#if DEBUG_LEAKS
+		vm->mpz_deleted++;
+	#endif
 }
 
 /*
@@ -1,4 +1,5 @@
 #include <cmath>
+#include <cstddef>
 #include <sstream>
 #include "LSNumber.hpp"
 #include "LSNull.hpp"
@@ -41,6 +42,80 @@ LSNumber::LSNumber(NUMBER_TYPE value) : LSValue(NUMBER), value(value) {}
 
 LSNumber::~LSNumber() {}
 
+/*
+ * Free list of number cells, per thread (one environment per thread).
+ * The chunks stay allocated while the thread lives: the pool keeps the peak number of boxes.
+ * They are freed at the exit of the thread, or later when the last box still alive is deleted.
+ * Disabled with AddressSanitizer to keep the use-after-free detection.
+ */
+#if !defined(__SANITIZE_ADDRESS__)
+	struct FreeNumber {
+		FreeNumber* next;
+	};
+	struct NumberChunk {
+		alignas(std::max_align_t) NumberChunk* next;
+	};
+	static const size_t NUMBER_CHUNK = 1024;
+	// Trivial thread locals, still usable by the boxes deleted after the destruction of the guard
+	static thread_local FreeNumber* free_numbers = nullptr;
+	static thread_local NumberChunk* number_chunks = nullptr;
+	static thread_local size_t live_numbers = 0;
+	static thread_local bool numbers_exited = false;
+
+	static void free_number_chunks() {
+		while (number_chunks) {
+			auto next = number_chunks->next;
+			::operator delete(number_chunks);
+			number_chunks = next;
+		}
+		free_numbers = nullptr;
+	}
+	struct NumberPoolGuard {
+		~NumberPoolGuard() {
+			numbers_exited = true;
+			if (live_numbers == 0) free_number_chunks();
+		}
+	};
+	static thread_local NumberPoolGuard number_pool_guard;
+#endif
+
+void* LSNumber::operator new(size_t size) {
+	#if !defined(__SANITIZE_ADDRESS__)
+		if (size == sizeof(LSNumber)) {
+			if (!free_numbers) {
+				(void) &number_pool_guard; // registers the release of the chunks at the exit of the thread
+				auto chunk = (NumberChunk*) ::operator new(sizeof(NumberChunk) + size * NUMBER_CHUNK);
+				chunk->next = number_chunks;
+				number_chunks = chunk;
+				auto cells = (char*) (chunk + 1);
+				for (size_t i = NUMBER_CHUNK; i-- > 0;) {
+					auto cell = (FreeNumber*) (cells + i * size);
+					cell->next = free_numbers;
+					free_numbers = cell;
+				}
+			}
+			auto cell = free_numbers;
+			free_numbers = cell->next;
+			live_numbers++;
+			return cell;
+		}
+	#endif
+	return ::operator new(size);
+}
+
+void LSNumber::operator delete(void* p, size_t size) {
+	#if !defined(__SANITIZE_ADDRESS__)
+		if (size == sizeof(LSNumber)) {
+			auto cell = (FreeNumber*) p;
+			cell->next = free_numbers;
+			free_numbers = cell;
+			if (--live_numbers == 0 and numbers_exited) free_number_chunks();
+			return;
+		}
+	#endif
+	::operator delete(p);
+}
+
 /*
  * LSNumber methods
  */
@@ -23,6 +23,13 @@ public:
 
 	virtual ~LSNumber();
 
+	/*
+	 * The boxes of the `any` numbers are mostly short-lived temporaries:
+	 * they are allocated from a free list of fixed-size cells instead of malloc
+	 */
+	static void* operator new(size_t size);
+	static void operator delete(void* p, size_t size);
+
 	/*
 	 * LSNumber
 	 */
@@ -27,10 +27,17 @@ LSObject::~LSObject() {
 	for (auto v : values) {
 		LSValue::delete_ref(v.second);
 	}
+	LSValue::allocated(-accounted_memory);
+}
+
+void LSObject::update_memory() {
+	// Red-black tree node : color, parent, left, right, the name and the value
+	LSValue::update_memory(accounted_memory, sizeof(LSObject) + values.size() * (4 * sizeof(void*) + sizeof(std::pair<std::string, LSValue*>)));
 }
 
 void LSObject::addField(const char* name, LSValue* var) {
 	values.insert({name, var->move_inc()});
+	update_memory();
 }
 
 void LSObject::std_add_field(LSObject* object, const char* name, LSValue* var) {
@@ -66,6 +73,7 @@ LSObject* base_map(const LSObject* object, F function) {
 		auto r = ls::call<LSValue*>(function, ls::clone(v.second));
 		result->values.insert({v.first, r->move_inc()});
 	}
+	result->update_memory();
 	LSValue::delete_temporary(object);
 	return result;
 }
@@ -181,6 +189,7 @@ LSValue** LSObject::attrL(const std::string& key) {
 		return &values.at(key);
 	} catch (std::exception& e) {
 		values.insert({key, LSNull::get()});
+		update_memory();
 		return &values[key];
 	}
 }
@@ -196,6 +205,7 @@ LSValue* LSObject::clone() const {
 	for (auto i = values.begin(); i != values.end(); i++) {
 		obj->values.insert({i->first, i->second->clone_inc()});
 	}
+	obj->update_memory();
 	return obj;
 }
 
@@ -14,11 +14,14 @@ public:
 	std::map<std::string, LSValue*> values;
 	LSClass* clazz;
 	bool readonly;
+	long accounted_memory = 0; // bytes counted in LSValue::memory
 
 	LSObject();
 	LSObject(LSClass*);
 	virtual ~LSObject();
 
+	void update_memory();
+
 	/** LSObject methods **/
 	void addField(const char* name, LSValue* value);
 	static void std_add_field(LSObject* object, const char* name, LSValue* value);
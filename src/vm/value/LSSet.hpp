@@ -2,6 +2,7 @@
 #define LS_SET_BASE
 
 #include "../LSValue.hpp"
+#include "NodeAllocator.hpp"
 #include <set>
 
 namespace ls {
@@ -12,8 +13,13 @@ struct lsset_less {
 };
 
 template <typename T>
-class LSSet : public LSValue, public std::set<T, lsset_less<T>> {
+using lsset_base = std::set<T, lsset_less<T>, NodeAllocator<T>>;
+
+template <typename T>
+class LSSet : public LSValue, public lsset_base<T> {
 public:
+	long accounted_memory = 0; // bytes counted in LSValue::memory
+
 	static LSSet<T>* constructor();
 
 	LSSet();
@@ -21,6 +27,8 @@ public:
 	LSSet(const LSSet<T>& other);
 	virtual ~LSSet();
 
+	void update_memory();
+
 	/*
 	 * LSSet methods
 	 */
@@ -30,26 +30,39 @@ template <class T>
 inline LSSet<T>::LSSet() : LSValue(SET) {}
 
 template <class T>
-LSSet<T>::LSSet(std::initializer_list<T> values) : LSValue(SET), std::set<T, lsset_less<T>>(values) {}
+LSSet<T>::LSSet(std::initializer_list<T> values) : LSValue(SET), lsset_base<T>(values) {
+	update_memory();
+}
 
 template <>
-inline LSSet<LSValue*>::LSSet(const LSSet<LSValue*>& other) : LSValue(other), std::set<LSValue*, lsset_less<LSValue*>>() {
+inline LSSet<LSValue*>::LSSet(const LSSet<LSValue*>& other) : LSValue(other), lsset_base<LSValue*>() {
 	for (LSValue* v : other) {
 		insert(end(), v->clone_inc());
 	}
+	update_memory();
 }
 
 template <typename T>
-inline LSSet<T>::LSSet(const LSSet<T>& other) : LSValue(other), std::set<T, lsset_less<T>>(other) {}
+inline LSSet<T>::LSSet(const LSSet<T>& other) : LSValue(other), lsset_base<T>(other) {
+	update_memory();
+}
 
 template <>
 inline LSSet<LSValue*>::~LSSet() {
 	for (auto it = begin(); it != end(); ++it) {
 		LSValue::delete_ref(*it);
 	}
+	LSValue::allocated(-accounted_memory);
 }
 template <typename T>
 inline LSSet<T>::~LSSet() {
+	LSValue::allocated(-accounted_memory);
+}
+
+template <typename T>
+inline void LSSet<T>::update_memory() {
+	// Red-black tree node : color, parent, left, right and the value
+	LSValue::update_memory(accounted_memory, sizeof(LSSet<T>) + this->size() * (4 * sizeof(void*) + sizeof(T)));
 }
 
 template <typename T>
@@ -64,6 +77,7 @@ inline bool LSSet<LSValue*>::std_insert(LSSet<LSValue*>* set, LSValue* value) {
 	auto it = set->lower_bound(value);
 	if (it == set->end() || (**it != *value)) {
 		set->insert(it, value->move_inc());
+		set->update_memory();
 		LSValue::delete_temporary(set);
 		return true;
 	}
@@ -80,6 +94,7 @@ inline LSValue* LSSet<LSValue*>::std_insert_ptr(LSSet<LSValue*>* set, LSValue* v
 template <typename T>
 inline bool LSSet<T>::std_insert(LSSet<T>* set, T value) {
 	bool r = set->insert(value).second;
+	set->update_memory();
 	return r;
 }
 
@@ -88,6 +103,7 @@ inline void LSSet<LSValue*>::vinsert(LSSet<LSValue*>* set, LSValue* value) {
 	auto it = set->lower_bound(value);
 	if (it == set->end() || (**it != *value)) {
 		set->insert(it, value->move_inc());
+		set->update_memory();
 	} else {
 		LSValue::delete_temporary(value);
 	}
@@ -95,6 +111,7 @@ inline void LSSet<LSValue*>::vinsert(LSSet<LSValue*>* set, LSValue* value) {
 template <typename T>
 inline void LSSet<T>::vinsert(LSSet<T>* set, T value) {
 	set->insert(value);
+	set->update_memory();
 }
 
 template <class T>
@@ -103,6 +120,7 @@ LSSet<T>* LSSet<T>::std_clear(LSSet<T>* set) {
 		ls::unref(v);
 	}
 	set->clear();
+	set->update_memory();
 	return set;
 }
 
@@ -116,6 +134,7 @@ inline bool LSSet<LSValue*>::std_erase(LSSet<LSValue*>* set, LSValue* value) {
 	} else {
 		LSValue::delete_ref(*it);
 		set->erase(it);
+		set->update_memory();
 		if (set->refs == 0) delete set;
 		return true;
 	}
@@ -123,6 +142,7 @@ inline bool LSSet<LSValue*>::std_erase(LSSet<LSValue*>* set, LSValue* value) {
 template <typename T>
 inline bool LSSet<T>::std_erase(LSSet<T>* set, T value) {
 	bool r = set->erase(value);
+	set->update_memory();
 	if (set->refs == 0) delete set;
 	return r;
 }
@@ -159,6 +179,7 @@ inline LSValue* LSSet<int>::add_eq(LSValue* v) {
 		}
 	}
 	LSValue::delete_temporary(v);
+	update_memory();
 	return this;
 }
 
@@ -177,6 +198,7 @@ inline LSValue* LSSet<double>::add_eq(LSValue* v) {
 		}
 	}
 	LSValue::delete_temporary(v);
+	update_memory();
 	return this;
 }
 
@@ -202,9 +224,11 @@ inline LSValue* LSSet<LSValue*>::add_eq(LSValue* v) {
 			}
 		}
 		LSValue::delete_temporary(v);
+		update_memory();
 		return this;
 	}
 	this->insert(this->end(), v->move_inc());
+	update_memory();
 	return this;
 }
 
@@ -217,6 +241,7 @@ LSValue* LSSet<T>::add_eq_int(int) {
 template <>
 inline LSValue* LSSet<int>::add_eq_int(int v) {
 	insert(v);
+	update_memory();
 	return this;
 }
 
@@ -229,6 +254,7 @@ LSValue* LSSet<T>::add_eq_double(double) {
 template <>
 inline LSValue* LSSet<double>::add_eq_double(double v) {
 	insert(v);
+	update_memory();
 	return this;
 }
 
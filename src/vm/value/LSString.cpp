@@ -56,11 +56,58 @@ LSString* LSString::constructor_2(char* s) {
 
 LSString::LSString() : LSValue(STRING) {}
 LSString::LSString(const char value) : LSValue(STRING), std::string(std::string(1, value)) {}
-LSString::LSString(const char* value) : LSValue(STRING), std::string(value) {}
-LSString::LSString(const std::string& value) : LSValue(STRING), std::string(value) {}
-LSString::LSString(const Json& json) : LSValue(STRING), std::string(json.get<std::string>()) {}
+LSString::LSString(const char* value) : LSValue(STRING), std::string(value) {
+	update_memory();
+}
+LSString::LSString(const std::string& value) : LSValue(STRING), std::string(value) {
+	update_memory();
+}
+LSString::LSString(const Json& json) : LSValue(STRING), std::string(json.get<std::string>()) {
+	update_memory();
+}
+
+LSString::~LSString() {
+	LSValue::allocated(-accounted_memory);
+}
+
+void LSString::update_memory() {
+	// Short strings are stored inside the object
+	auto heap = capacity() > 15 ? capacity() + 1 : 0;
+	long bytes = sizeof(LSString) + heap;
+	if (bytes > accounted_memory and accounted_memory > (long) sizeof(LSString)) {
+		LSValue::memory->counters.reallocations++;
+	}
+	LSValue::update_memory(accounted_memory, bytes);
+}
 
-LSString::~LSString() {}
+LSString* LSString::share(LSString* string) {
+	if (string->native) return string;
+	if (string->refs == 0) {
+		string->shares = 0;
+	} else if (string->shares < UINT16_MAX) {
+		string->shares++;
+	} else {
+		string = (LSString*) string->clone();
+		LSValue::memory->counters.clones++;
+	}
+	string->refs++;
+	return string;
+}
+
+LSString* LSString::unshare(LSString** string) {
+	auto s = *string;
+	if (s->shares == 0) return s;
+	if (s->refs > 1) {
+		s->shares--;
+		s->refs--;
+		*string = (LSString*) s->clone();
+		(*string)->refs = 1;
+		LSValue::memory->counters.clones++;
+	} else {
+		s->shares = 0;
+	}
+	return *string;
+}
 
 LSString* LSString::charAt(const LSString* const string, int index) {
 	return new LSString(string->operator[] (index));
@@ -230,6 +277,7 @@ LSValue* LSString::add(LSValue* v) {
 	if (refs == 0) {
 		this->append(v->to_string());
 		LSValue::delete_temporary(v);
+		update_memory();
 		return this;
 	}
 	auto r = new LSString(*this + v->to_string());
@@ -244,6 +292,7 @@ LSValue* LSString::add_eq(LSValue* v) {
 		append(v->to_string());
 	}
 	LSValue::delete_temporary(v);
+	update_memory();
 	return this;
 }
 
@@ -260,7 +309,8 @@ LSValue* LSString::mul(LSValue* v) {
 	}
 	if (number->refs == 0) delete number;
 	if (refs == 0) {
-		*this = r;
+		this->assign(r);
+		update_memory();
 		return this;
 	}
 	return new LSString(r);
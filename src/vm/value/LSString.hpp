@@ -27,6 +27,8 @@ public:
 	static LSString* constructor_1();
 	static LSString* constructor_2(char* s);
 
+	long accounted_memory = 0; // bytes counted in LSValue::memory
+
 	LSString();
 	LSString(char);
 	LSString(const char*);
@@ -35,6 +37,15 @@ public:
 
 	virtual ~LSString();
 
+	void update_memory();
+
+	/*
+	 * Copy-on-write of the strings (Environment::copy_on_write): a local variable assigned
+	 * from another one shares its string, the string is copied before being modified.
+	 */
+	static LSString* share(LSString* string);
+	static LSString* unshare(LSString** string);
+
 	static LSString* charAt(const LSString* const string, int index);
 	static LSString* codePointAt(const LSString* const string, int index);
 	int unicode_length() const;
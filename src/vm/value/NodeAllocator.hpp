@@ -0,0 +1,90 @@
+#ifndef LS_NODE_ALLOCATOR
+#define LS_NODE_ALLOCATOR
+
+#include <cstddef>
+#include <new>
+
+namespace ls {
+
+/*
+ * Free list of the nodes of a size, per thread. The list itself is trivial, so it stays usable
+ * by the nodes freed after the destruction of the guard at the exit of the thread: from then,
+ * they go back to the system.
+ */
+template <size_t SIZE>
+class NodePool {
+public:
+	static const size_t MAX_NODES = 4096;
+
+	static void* pop() {
+		if (not head) return nullptr;
+		auto node = head;
+		head = *(void**) node;
+		size--;
+		return node;
+	}
+	static bool push(void* node) {
+		if (exited or size >= MAX_NODES) return false;
+		(void) &guard; // registers the release of the list at the exit of the thread
+		*(void**) node = head;
+		head = node;
+		size++;
+		return true;
+	}
+
+private:
+	struct Guard {
+		~Guard() {
+			exited = true;
+			while (head) {
+				auto next = *(void**) head;
+				::operator delete(head);
+				head = next;
+			}
+			size = 0;
+		}
+	};
+	static thread_local void* head;
+	static thread_local size_t size;
+	static thread_local bool exited;
+	static thread_local Guard guard;
+};
+
+template <size_t SIZE> thread_local void* NodePool<SIZE>::head = nullptr;
+template <size_t SIZE> thread_local size_t NodePool<SIZE>::size = 0;
+template <size_t SIZE> thread_local bool NodePool<SIZE>::exited = false;
+template <size_t SIZE> thread_local typename NodePool<SIZE>::Guard NodePool<SIZE>::guard;
+
+/*
+ * Allocator of the nodes of the maps and sets: a freed node is kept and reused by the next
+ * insertion, so the small maps built and destroyed in a loop don't call malloc and free for
+ * each entry. Stateless: the layout of the trees, read by the compiled iterations, is unchanged.
+ */
+template <class T>
+struct NodeAllocator {
+	using value_type = T;
+
+	NodeAllocator() = default;
+	template <class U>
+	NodeAllocator(const NodeAllocator<U>&) {}
+
+	T* allocate(size_t n) {
+		if (n == 1 and sizeof(T) >= sizeof(void*)) {
+			if (auto node = NodePool<sizeof(T)>::pop()) return (T*) node;
+		}
+		return (T*) ::operator new(n * sizeof(T));
+	}
+	void deallocate(T* p, size_t n) {
+		if (n == 1 and sizeof(T) >= sizeof(void*) and NodePool<sizeof(T)>::push(p)) return;
+		::operator delete(p);
+	}
+};
+
+template <class T, class U>
+bool operator == (const NodeAllocator<T>&, const NodeAllocator<U>&) { return true; }
+template <class T, class U>
+bool operator != (const NodeAllocator<T>&, const NodeAllocator<U>&) { return false; }
+
+}
+
+#endif
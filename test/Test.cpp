@@ -42,7 +42,7 @@ int Test::all() {
 	std::vector<std::function<void(Test*)>> tests = {
 		&Test::test_types,
 		&Test::test_utils,
-		// &Test::test_legacy_array, // Not used for now
+		&Test::test_legacy_array,
 		&Test::test_general,
 		&Test::test_booleans,
 		&Test::test_numbers,
@@ -175,6 +175,18 @@ ls::Environment& Test::getEnv(bool legacy) {
 	}
 }
 
+/*
+ * Analyze, compile and execute a code in a given environment, for the tests of its options
+ */
+ls::Result Test::run(ls::Environment& env, const std::string& code, ls::Context* ctx) {
+	ls::Program program { env, code, "test" };
+	program.context = ctx;
+	env.analyze(program);
+	env.compile(program);
+	env.execute(program);
+	return program.result;
+}
+
 ls::Result Test::Input::run(bool display_errors, bool ops) {
 	test->total++;
 
@@ -182,6 +194,9 @@ ls::Result Test::Input::run(bool display_errors, bool ops) {
 
 	auto& env = test->getEnv(v1);
 	env.operation_limit = ops ? ls::VM::DEFAULT_OPERATION_LIMIT : this->operation_limit;
+	env.memory_limit = this->memory_limit;
+	env.copy_on_write = this->copy_on_write;
+	env.parallel_compilation = this->parallel_compilation;
 	ls::Program program { env, code, file_name };
 	program.context = ctx;
 	env.analyze(program);
@@ -194,10 +209,10 @@ ls::Result Test::Input::run(bool display_errors, bool ops) {
 	test->mpz_obj_created += result.mpz_objects_created;
 	test->mpz_obj_deleted += result.mpz_objects_deleted;
 
-	parse_time = result.parse_time;
+	parse_time = result.parse_time + result.analyze_time;
 	compilation_time = result.compilation_time;
 	execution_time = result.execution_time;
-	test->parse_time += result.parse_time;
+	test->parse_time += result.parse_time + result.analyze_time;
 	test->compilation_time += result.compilation_time;
 	test->execution_time += result.execution_time;
 
@@ -422,6 +437,18 @@ Test::Input& Test::Input::ops_limit(long int ops) {
 	this->operation_limit = ops;
 	return *this;
 }
+Test::Input& Test::Input::memory(long bytes) {
+	this->memory_limit = bytes;
+	return *this;
+}
+Test::Input& Test::Input::cow() {
+	this->copy_on_write = true;
+	return *this;
+}
+Test::Input& Test::Input::sequential() {
+	this->parallel_compilation = false;
+	return *this;
+}
 Test::Input& Test::Input::context(ls::Context* ctx) {
 	this->ctx = ctx;
 	return *this;
@@ -48,6 +48,7 @@ public:
 	Input file_v1(const std::string& file_name);
 
 	ls::Environment& getEnv(bool legacy = false);
+	ls::Result run(ls::Environment& env, const std::string& code, ls::Context* ctx = nullptr);
 
 	template <class T1, class T2>
 	void test(const std::string& label, T1 value, T2 expected) {
@@ -105,6 +106,9 @@ public:
 		double compilation_time = 0;
 		double execution_time = 0;
 		long int operation_limit = -1;
+		long memory_limit = 0;
+		bool copy_on_write = false;
+		bool parallel_compilation = true;
 		ls::Result result;
 		ls::Context* ctx = nullptr;
 
@@ -123,6 +127,9 @@ public:
 		void type(const ls::Type*);
 		Input& timeout(int ms);
 		Input& ops_limit(long int ops);
+		Input& memory(long bytes);
+		Input& cow();
+		Input& sequential();
 		Input& context(ls::Context* ctx);
 
 		ls::Result run(bool display_errors = true, bool ops = false);
@@ -151,6 +151,16 @@ void Test::test_arrays() {
 	code("let a = [[12], ''][0] a[100]++ a").exception(ls::vm::Exception::ARRAY_OUT_OF_BOUNDS);
 	code("let a = [5] let e = a[1] !? 5 e").equals("5");
 
+	section("Access in a for loop over the array");
+	code("var a = [1, 2, 3, 4] var s = 0 for (var i = 0; i < a.size(); i++) { s += a[i] } s").equals("10");
+	code("var a = [1.5, 2.5] var s = 0.0 for (var i = 0; i < a.size(); ++i) { s += a[i] } s").equals("4");
+	code("var a = [1, 2, 3] for (var i = 0; i < a.size(); i += 1) { a[i] = a[i] * 2 } a").equals("[2, 4, 6]");
+	code("var a = ['a', 'b'] var s = '' for (var i = 0; i < a.size(); i++) { s += a[i] } s").equals("'ab'");
+	code("var a = [1, 2, 3] var s = 0 for (var i = 0; i < a.size(); i++) { s += a[i + 1] } s").exception(ls::vm::Exception::ARRAY_OUT_OF_BOUNDS);
+	code("var a = [1, 2, 3] var s = 0 for (var i = 0; i < a.size(); i++) { i += 5 s += a[i] } s").exception(ls::vm::Exception::ARRAY_OUT_OF_BOUNDS);
+	code("var a = [1, 2, 3] var s = 0 for (var i = 0; i < a.size(); i++) { a.clear() s += a[i] } s").exception(ls::vm::Exception::ARRAY_OUT_OF_BOUNDS);
+	code("var a = [1, 2, 3] var s = 0 for (var i = 0; i < a.size(); i++) { a = [1] s += a[i] } s").exception(ls::vm::Exception::ARRAY_OUT_OF_BOUNDS);
+
 	section("Access with booleans");
 	code("[1, 2, 3][false]").equals("1");
 	code("[1, 2, 3][true]").equals("2");
@@ -410,6 +420,10 @@ void Test::test_arrays() {
 	code("let a = [3, 4, 5] a.filter(x -> x < 5)").equals("[3, 4]");
 	code("let a = ['a', 'b', 'a'] a.filter(x -> x == 'a')").equals("['a', 'a']");
 	code("[1l, 2l, 3l, 4l, 5l, 6l, 7l].filter(x -> x > 3)").equals("[4, 5, 6, 7]");
+	// Exception in the function on a temporary array compacted in place
+	code("[[1, 0], [2]].filter(x -> x[1] > 0)").exception(ls::vm::Exception::ARRAY_OUT_OF_BOUNDS);
+	code("[[1, 0], [2, 1], [3]].filter(x -> x[1] > 0)").exception(ls::vm::Exception::ARRAY_OUT_OF_BOUNDS);
+	code("[[1, 0], [2]].filter(x -> x[1] > 0) !? 'caught'").equals("'caught'");
 
 	section("Array.contains()");
 	code("Array.contains([1, 2, 3, 10, 1], 1)").equals("true");
@@ -431,6 +445,25 @@ void Test::test_arrays() {
 	code("var a = '' Array.iter([1, 2, 3], x -> a += x) a").equals("'123'");
 	code("var s = 0 [1, 2, 3, 4, 5].iter(x -> s += x) s").equals("15");
 
+	section("Array pipelines");
+	code("[1, 2, 3, 4, 5, 6].filter(x -> x % 2 == 0).map(x -> x * 10).sum()").equals("120");
+	code("[1.5, 2.5, 3.5].map(x -> x * 2).sum()").equals("15");
+	code("[1, 2, 3, 4].map(x -> x * x).filter(x -> x > 4)").equals("[9, 16]");
+	code("[1, 2, 3, 4].filter(x -> x > 1).filter(x -> x < 4).map(x -> x + 0.5)").equals("[2.5, 3.5]");
+	code("['a', 'bb', 'ccc'].filter(x -> x.size() > 1).map(x -> x + '!')").equals("['bb!', 'ccc!']");
+	code("[[1], [2, 3], [4, 5, 6]].map(x -> x.size()).filter(x -> x > 1)").equals("[2, 3]");
+	code("[[1], [2, 3], [4, 5, 6]].filter(x -> x.size() > 1).map(x -> x)").equals("[[2, 3], [4, 5, 6]]");
+	code("[1, 2, 3].map(x -> [x]).filter(x -> x[0] != 2)").equals("[[1], [3]]");
+	code("var s = 0 [1, 2, 3, 4].map(x -> x * 2).iter(x -> s += x) s").equals("20");
+	code("[1, 2, 3].map(x -> x + 1).map(x -> x * 2).map(x -> x - 1)").equals("[3, 5, 7]");
+	code("[1, 2, 3].filter(x -> x > 5).map(x -> x * 2).sum()").equals("0");
+	code("[1..5].map(x -> x * 2).filter(x -> x > 4)").equals("[6, 8, 10]");
+	// Side effects: not fused, each stage runs on the whole array
+	code("var l = '' [1, 2].map(x -> { l += 'm' + x return x }).filter(x -> { l += 'f' + x return true }) l").equals("'m1m2f1f2'");
+	code("var l = '' [1, 2].map(x -> { l += 'm' + x return x }).iter(x -> { l += 'i' + x }) l").equals("'m1m2i1i2'");
+	code("['a', 'b'].map(x -> x + '.').sum()").equals("'a.b.'");
+	code("var a = [1, 2, 3] a.filter(x -> x > 1).map(x -> x * 2) a").equals("[1, 2, 3]");
+
 	section("Array.partition()");
 	code("Array.partition([1, 2, 3, 4, 5], (x -> x < 3))").equals("[[1, 2], [3, 4, 5]]");
 	code("Array.partition([1, 2, 3, 10, true, 'yo'], x -> x > 2)").equals("[[3, 10, 'yo'], [1, 2, true]]");
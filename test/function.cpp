@@ -104,6 +104,53 @@ void Test::test_functions() {
 	code("var a = 2 a++ let f = x => x + a print(f(10)) a += 5 print(f(10))").output("13\n18\n");
 	DISABLED_code("function g(a) { a++ let f = x => x + a a += 5 f(10) } g(10)").equals("26");
 	DISABLED_code("let f = -> 12 let g = -> f g()()").equals("12");
+	code("let a = 1, b = 2, c = 3, d = 4, e = 5, f = 6, g = 7, h = 8 let k = x -> x + a + b + c + d + e + f + g + h k(100)").equals("136");
+	code("let a = 'a', b = 'b', c = 'c' let f = x -> x + a + b + c + a [f('x'), f('y')]").equals("['xabca', 'yabca']");
+	code("let a = [1, 2] let f = -> a.size() var s = 0 for (var i = 0; i < 100; ++i) { s += f() } s").equals("200");
+
+	section("Inlined calls");
+	code("let sq = x -> x * x var s = 0 for (var i = 0; i < 10; ++i) { s += sq(i) } s").equals("285");
+	code("function add(a, b) { return a + b } function twice(x) { return add(x, x) } twice(21)").equals("42");
+	code("[1, 2, 3].map(x -> x * 2)").equals("[2, 4, 6]");
+	code("function f(x) { if (x > 2) throw 'err' return x } [f(1), f(2)]").equals("[1, 2]");
+
+	section("Version cache");
+	code("function sum(a) { var s = 0 for (x in a) { s += x } return s } sum([1, 2, 3])").equals("6");
+	code("function sum(a) { var s = 0 for (x in a) { s += x } return s } sum([1, 2, 3])").equals("6");
+	code("function sum(a) { var s = 0 for (x in a) { s += x } return s } [sum([1, 2, 3]), sum([1.5, 2.5])]").equals("[6, 4]");
+	code("function sum(a) { var s = 1 for (x in a) { s *= x } return s } sum([1, 2, 3, 4])").equals("24");
+	code("function fib(n) { return n <= 1 ? n : fib(n - 1) + fib(n - 2) } fib(20)").equals("6765");
+	code("function fib(n) { return n <= 1 ? n : fib(n - 1) + fib(n - 2) } fib(20)").equals("6765");
+	code("var k = 2 function mul(x) { return x * k } mul(21)").equals("42");
+	code("var k = 3 function mul(x) { return x * k } mul(21)").equals("63");
+	code("function f(x) { if (x > 2) throw 'err' return x } [f(1), f(2)]").equals("[1, 2]");
+
+	section("Lazy compilation");
+	std::string functions;
+	for (int i = 0; i < 60; ++i) {
+		functions += "function f" + std::to_string(i) + "(x) { return x + " + std::to_string(i) + " } ";
+	}
+	code(functions + "f3(f59(1))").sequential().equals("63");
+	code(functions + "[f0(1), f10(2.5), f42('a')]").sequential().equals("[1, 12.5, 'a42']");
+	code(functions + "function g(n) { if (n > 3) throw 'err' return f1(n) } [g(1), g(2)]").sequential().equals("[2, 3]");
+	code(functions + "let fib = n -> if n <= 1 { n } else { fib(n - 1) + fib(n - 2) } fib(15)").sequential().equals("610");
+
+	// With several threads, the program is compiled in parallel rather than lazily
+	code(functions + "f3(f59(1))").equals("63");
+
+	section("Parallel compilation");
+	std::string parallel_functions;
+	for (int i = 0; i < 40; ++i) {
+		parallel_functions += "function p" + std::to_string(i) + "(x) { return x * 2 + " + std::to_string(i) + " } ";
+	}
+	code(parallel_functions + "p0(p39(1))").equals("82");
+	code(parallel_functions + "function g(n) { if (n > 3) throw 'err' return p1(n) } [g(1), g(2), p20(1.5)]").equals("[3, 5, 23]");
+	code(parallel_functions + "function fact(n) { return n <= 1 ? 1 : n * fact(n - 1) } fact(10)").equals("3628800");
+
+	section("Maximum number of versions");
+	code("let f = x -> [x] [f(1), f(1.5), f(2l), f(true), f('a'), f([1]), f([1.5]), f(['a']), f({}), f(null)]").equals("[[1], [1.5], [2], [true], ['a'], [[1]], [[1.5]], [['a']], [{}], [null]]");
+	code("let f = (x, y) -> x + y [f(1, 2), f(1.5, 2), f(1, 2.5), f('a', 1), f(1, 'a'), f([1], 2), f(2l, 3), f(true, 1), f(1, 2l), f('a', 'b'), f(2, 2)]").equals("[3, 3.5, 3.5, 'a1', '1a', [1, 2], 5, 2, 3, 'ab', 4]");
+	code("let f = (x, y) -> x * y [f(1.5, 2), f(2, 1.5), f(1.5, 1.5), f(2l, 1.5), f(1.5, 2l), f(2l, 2), f(2, 2l), f('a', 2), f(65536, 65536), f(9007199254740993l, 1l)]").equals("[3, 3, 2.25, 3, 3, 4, 4, 'aa', 0, 9007199254740993]");
 
 	section("Recursive");
 	code("let fact = x -> if x == 1 { 1 } else { fact(x - 1) * x } fact(8)").equals("40320");
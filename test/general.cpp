@@ -1,6 +1,9 @@
+#include <cstdio>
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <filesystem>
+#include <unistd.h>
 #include "Test.hpp"
 #include "../src/analyzer/Context.hpp"
 #include "../src/analyzer/lexical/LexicalAnalyzer.hpp"
@@ -31,6 +34,90 @@ void Test::test_general() {
 	o.addField("test", ls::LSNumber::get(12));
 	std::cout << o.getField("test") << std::endl;
 
+	/*
+	 * Environments: each test has its own, independent of the ones before
+	 */
+	header("Environments");
+	section("Environment pool");
+	ls::Environment* pooled;
+	{
+		auto env1 = ls::Environment::acquire();
+		pooled = env1.get();
+		env1->operation_limit = 1000;
+		test("Pooled environment", run(*env1, "[1, 2, 3].size()").value, std::string("3"));
+	}
+	{
+		auto env2 = ls::Environment::acquire();
+		test("Environment reused", env2.get() == pooled, true);
+		test("Options reset", env2->operation_limit, -1);
+		test("Operation limit reset", run(*env2, "var s = 0 for i in [1..2000] { s += i } s").value, std::string("2001000"));
+	}
+
+	section("Instrumentation counters");
+	{
+		ls::Environment environment { false };
+		environment.instrumentation = true;
+		auto result = run(environment, "var a = [] for i in [1..1000] { a.push(i) } a.size()");
+		test("Instrumented", result.instrumented, true);
+		test("Reallocations counted", result.reallocations > 0, true);
+		test("Allocations counted", result.allocated_bytes >= 1000 * 8, true);
+	}
+
+	section("Batch compilation");
+	{
+		ls::Environment environment { false };
+		ls::Program p1 { environment, "function f(x) { return x + 1 } f(2)", "batch1" };
+		ls::Program p2 { environment, "function f(x) { return x * 2 } f(5)", "batch2" };
+		ls::Program p3 { environment, "[1, 2, 3].map(x -> x * 2)", "batch3" };
+		for (auto p : { &p1, &p2, &p3 }) environment.analyze(*p);
+		environment.compile({ &p1, &p2, &p3 });
+		for (auto p : { &p3, &p1, &p2 }) environment.execute(*p);
+		test("Batch program 1", p1.result.value, std::string("3"));
+		test("Batch program 2", p2.result.value, std::string("10"));
+		test("Batch program 3", p3.result.value, std::string("[2, 4, 6]"));
+	}
+	{
+		// Each program of the batch reads the variables of its own context
+		ls::Environment environment { false };
+		ls::Context ctx1 { environment };
+		ls::Context ctx2 { environment };
+		run(environment, "var a = 2", &ctx1);
+		run(environment, "var a = 5", &ctx2);
+		ls::Program p1 { environment, "a * 10", "batch1" };
+		ls::Program p2 { environment, "a * 10", "batch2" };
+		p1.context = &ctx1;
+		p2.context = &ctx2;
+		for (auto p : { &p1, &p2 }) environment.analyze(*p);
+		environment.compile({ &p1, &p2 });
+		for (auto p : { &p1, &p2 }) environment.execute(*p);
+		test("Batch context 1", p1.result.value, std::string("20"));
+		test("Batch context 2", p2.result.value, std::string("50"));
+	}
+
+	section("Ahead-of-time compilation");
+	{
+		// The object is loaded by another environment, after the end of the one that wrote it:
+		// an address of its VM or of its compiler baked in the object would not be valid anymore
+		auto folder = std::filesystem::temp_directory_path() / ("leekscript-aot-" + std::to_string(getpid()));
+		std::filesystem::create_directories(folder);
+		auto file = (folder / "aot_test").string();
+		std::string code = "function inc(x) { return x + 1 } [inc(1), inc(2), inc(3)]";
+		{
+			ls::Environment environment { false };
+			// The version of inc is in the cache of the environment: the object must not link it
+			run(environment, code);
+			ls::Program program { environment, code, file };
+			environment.analyze(program);
+			environment.compile(program, false, false, false, false, false, false, false, false, true);
+		}
+		ls::Environment environment { false };
+		ls::Program loaded { environment, "", file + ".o" };
+		environment.compile(loaded, false, false, false, false, false, false, false, false, false, true);
+		environment.execute(loaded);
+		test("Object file", loaded.result.value, std::string("[2, 3, 4]"));
+		std::filesystem::remove_all(folder);
+	}
+
 	header("Basic codes");
 	code("").equals("(void)");
 	code(" ").equals("(void)"); // classic space
@@ -52,6 +52,8 @@ void Test::test_intervals() {
 	code("[1..1000][500]").equals("501");
 	code("[1000..2000][12]").equals("1012");
 	code("[-100..0][5]").equals("-95");
+	code("var a = 10 [a..a + 5][2]").equals("12");
+	code("var a = 10 [a..a + 5][6]").exception(ls::vm::Exception::ARRAY_OUT_OF_BOUNDS);
 	code("['', [10..20]][1][5]").equals("15");
 	code("['', [10..20]][1][50]").exception(ls::vm::Exception::ARRAY_OUT_OF_BOUNDS);
 	code("[1..10]['hello']").error( ls::Error::Type::ARRAY_ACCESS_KEY_MUST_BE_NUMBER, {"'hello'", "[1..10]", env.tmp_string->to_string()});
@@ -89,6 +91,10 @@ void Test::test_intervals() {
 	code("var s = 0 for i in [100..110] { s += i } s").equals("1155");
 	code("var s = 0 for k, i in [100..110] { s += k * i } s").equals("5885");
 	code("var s = 0l for i in [0..1000] { s += i ** 2 } s").equals("333833500");
+	code("var s = 0 for i in [1..0] { s++ } s").equals("0");
+	code("var a = 3 var b = 6 var s = 0 for i in [a..b] { s += i } s").equals("18");
+	code("let i = [5..7] var s = 0 for k, x in i { s += k * x } s").equals("20");
+	code("var s = 0 for i in [1..3] { for j in [i..3] { s += j } } s").equals("14");
 
 	/*
 	 * Methods
@@ -126,6 +132,7 @@ void Test::test_intervals() {
 	code("[-100..100].sum()").equals("0");
 	code("[-100..0].sum() + [0..200].sum()").equals("15050");
 	code("[-100..200].sum()").equals("15050");
+	code("[1..100000].sum()").equals("5000050000");
 
 	section("Interval.product");
 	code("[1..0].product()").equals("1");
@@ -102,6 +102,40 @@ void Test::test_legacy_array() {
     empty->removeIndex(0);
     test("empty.print()", empty->to_string(), "[]");
 
+    section("packed and associative");
+    auto a3 = new ls::LSLegacyArray(vm);
+    for (int i = 0; i < 5; ++i) {
+        a3->push(ls::LSNumber::get(i * 10));
+    }
+    test("print", a3->to_string(), "[0, 10, 20, 30, 40]");
+    action("a3.remove(4) a3.push(99)");
+    a3->remove(new ls::Key(4));
+    a3->push(ls::LSNumber::get(99));
+    test("print", a3->to_string(), "[0 => 0, 1 => 10, 2 => 20, 3 => 30, 5 => 99]");
+    action("a3.set('x', 1) a3.removeIndex(0)");
+    a3->set(new ls::Key("x"), ls::LSNumber::get(1));
+    a3->removeIndex(0);
+    test("print", a3->to_string(), "[0 => 10, 1 => 20, 2 => 30, 3 => 99, 'x' => 1]");
+    action("a3.remove('x') a3.reverse()");
+    a3->remove(new ls::Key("x"));
+    a3->reverse();
+    test("print", a3->to_string(), "[99, 30, 20, 10]");
+    test("get(1)", a3->get(1)->to_string(), "30");
+    test("get('x')", a3->get("x")->to_string(), "null");
+
+    auto a4 = new ls::LSLegacyArray(vm);
+    for (int i = 0; i < 1000; ++i) {
+        a4->set(new ls::Key("k" + std::to_string(i)), ls::LSNumber::get(i));
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        a4->remove(new ls::Key("k" + std::to_string(i)));
+    }
+    test("size()", a4->size(), 500);
+    test("get('k501')", a4->get("k501")->to_string(), "501");
+    test("containsKey('k500')", a4->containsKey(new ls::Key("k500")), false);
+    test("start()", a4->start()->to_string(), "1");
+    test("end()", a4->end()->to_string(), "999");
+
     const size_t S = 613;
     section("large legacy array");
     auto exe_start = std::chrono::high_resolution_clock::now();
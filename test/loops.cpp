@@ -291,4 +291,29 @@ void Test::test_loops() {
 	DISABLED_code("let b = 'b' match 'e' { ..b: 1 1..6|0..9: 2 ..|..: 3}").equals("3");
 	DISABLED_code("let a = match 3 { 1 : 1 2 : 2 3 : 3 } a").equals("3");
 	DISABLED_code("match 2 { 1 : 1 2 : {} 3 : 3 }").equals("{}");
+
+	section("Match on constants: switch");
+	code("match 7 { 1 : 'a' 2|3 : 'b' 5|7 : 'c' .. : 'd' }").equals("'c'");
+	code("match 8 { 1 : 'a' 2|3 : 'b' 5|7 : 'c' .. : 'd' }").equals("'d'");
+	code("match 4 { 1 : 'a' 2 : 'b' 3 : 'c' }").equals("null");
+	code("match 2 { 2 : 'a' 2 : 'b' }").equals("'a'");
+	code("match 9 { 1 : 'a' .. : 'd' 9 : 'e' }").equals("'d'");
+	// Dense
+	code("var r = 0 for (var i = 0; i < 10; i++) { r += match i { 0 : 1 1 : 2 2 : 3 3 : 4 4 : 5 .. : 0 } } r").equals("15");
+	code("var r = [] for (var i = 0; i < 6; i++) { r.push(match i { 0|1 : 'a' 2 : 'b' 3|4 : 'c' .. : 'd' }) } r").equals("['a', 'a', 'b', 'c', 'c', 'd']");
+	// Sparse
+	code("var r = [] for x in [1, 100, 10000, 5] { r.push(match x { 1 : 'a' 100 : 'b' 10000 : 'c' .. : 'd' }) } r").equals("['a', 'b', 'c', 'd']");
+	code("match 1000000 { 10 : 1 1000000 : 2 }").equals("2");
+	// Strings
+	code("match 'c' { 'a' : 1 'b'|'c' : 2 'd' : 3 .. : 4 }").equals("2");
+	code("match 'e' { 'a' : 1 'b'|'c' : 2 'd' : 3 }").equals("null");
+	code("match 'z' { 'a' : 1 'b'|'c' : 2 'd' : 3 .. : 4 }").equals("4");
+	code("var r = [] for s in ['a', 'b', 'x'] { r.push(match s { 'a' : 1 'b' : 2 .. : 3 }) } r").equals("[1, 2, 3]");
+	// In a function
+	code("function f(x) { return match x { 1 : 'a' 2 : 'b' .. : 'c' } } [f(1), f(2), f(3)]").equals("['a', 'b', 'c']");
+	// Other patterns: chain of comparisons
+	code("match 3 { 1 : 'a' 2..5 : 'b' .. : 'c' }").equals("'b'");
+	code("match 7 { 1 : 'a' 2..5 : 'b' .. : 'c' }").equals("'c'");
+	code("let x = 2 match 2 { 1 : 'a' x : 'b' .. : 'c' }").equals("'b'");
+	code("match 2.5 { 1 : 'a' 2.5 : 'b' .. : 'c' }").equals("'b'");
 }
@@ -228,4 +228,9 @@ void Test::test_map() {
 	code("['c' : 'c', 'a' : 'a', 'd' : 'd', 'b' : 'b'].minKey()").equals("'a'");
 	code("let a = ['c' : 'c', 'a' : 'a', 'd' : 'd', 'b' : 'b'] a.minKey()").equals("'a'");
 	code("[0 : 4.01, 42 : 20.5, 100 : 10, -1 : 4.99].minKey()").equals("-1");
+
+	section("Small maps in a loop");
+	code("var s = 0 for (var i = 0; i < 1000; i++) { var m = [i : 1, i + 1 : 2, i + 2 : 3] s += m.size() + m[i + 1] } s").equals("5000");
+	code("var s = '' for (var i = 0; i < 3; i++) { var m = ['b' : i, 'a' : i * 2] for (k, v in m) { s += k + v } } s").equals("'a0b0a2b1a4b2'");
+	code("var m = [:] for (var i = 0; i < 100; i++) { m[i % 7] = i } [m.size(), m[3]]").equals("[7, 94]");
 }
@@ -283,6 +283,11 @@ void Test::test_numbers() {
 	code("5 * 'yo'").equals("'yoyoyoyoyo'");
 	code("50m * 10").equals("500");
 	code("50 * 10m").equals("500");
+	// Small values computed inline, GMP on overflow
+	code("4611686018427387904m * 2").equals("9223372036854775808");
+	code("-4611686018427387904m * 2").equals("-9223372036854775808");
+	code("9223372036854775807m + 1").equals("9223372036854775808");
+	code("var a = 1m for (var i = 1; i <= 25; i++) { a *= i } a").equals("15511210043330985984000000");
 	code("let a = ['a', 12321111111111111111111111111111111321321321999999] a[1] * 123456789").equals("1521124814690000000000000000000000025951877651354934543211");
 
 	section("Number.operator *=");
@@ -384,6 +389,8 @@ void Test::test_numbers() {
 	code("(5m + 5m) < (3m * 4m)").equals("true");
 	code("(5m + 5m) < 12m").equals("true");
 	code("3m < 4").equals("true");
+	code("-5m < 3").equals("true");
+	code("9223372036854775808m < 5").equals("false");
 
 	section("Number.operator <=");
 	code("5 <= 2").equals("false");
@@ -21,4 +21,16 @@ void Test::test_operations() {
 	section("Operation limit exceeded");
 	code("while true {}").ops_limit(1000).exception(ls::vm::Exception::OPERATION_LIMIT_EXCEEDED);
 	code("for ;; {}").ops_limit(1000).exception(ls::vm::Exception::OPERATION_LIMIT_EXCEEDED);
+
+	section("Memory limit exceeded");
+	code("var a = [] while true { a.push(12) }").memory(1000000).exception(ls::vm::Exception::MEMORY_LIMIT_EXCEEDED);
+	code("var a = [] while true { a.push('a') }").memory(1000000).exception(ls::vm::Exception::MEMORY_LIMIT_EXCEEDED);
+	code("var s = 'a' while true { s += 'abcdef' }").memory(1000000).exception(ls::vm::Exception::MEMORY_LIMIT_EXCEEDED);
+	code("var m = [0: 0] var i = 0 while true { m[i] = i i++ }").memory(1000000).exception(ls::vm::Exception::MEMORY_LIMIT_EXCEEDED);
+	code("var s = <0> var i = 0 while true { s.insert(i) i++ }").memory(1000000).exception(ls::vm::Exception::MEMORY_LIMIT_EXCEEDED);
+	code("var a = [] for i in [1..1000] { a.push(i) } a.size()").memory(1000000).equals("1000");
+	code("{ var a = [] while true { a.push(12) } a.size() } !? -1").memory(1000000).equals("-1");
+	code("var r = { var s = '' while true { s += 'abcdef' } 0 } !? 1 r + 1").memory(1000000).equals("2");
+	// Exceeded after the last check of the compiled code: reported by the VM, without frame
+	code("'abcdef' * 1000000").memory(1000000).exception(ls::vm::Exception::MEMORY_LIMIT_EXCEEDED, {});
 }
@@ -211,6 +211,17 @@ void Test::test_operators() {
 	code_v1("[0, ''][0] === false").equals("false");
 	code("1 === 1").error(ls::Error::NO_SUCH_OPERATOR, {env.integer->to_string(), "===", env.integer->to_string()});
 
+	header("Type feedback");
+	// Each program runs twice : the first compilation counts the types of the `any` operands, the second one speculates on numbers
+	for (int i = 0; i < 2; ++i) {
+		code_v1("var s = 0 for (var i = 0; i < 100; i++) { s = s + i } s").equals("4950");
+		code_v1("var s = 1000 for (var i = 0; i < 100; i++) { s = s - i } s").equals("-3950");
+		code_v1("var c = 0 for (var i = 0; i < 100; i++) { if (i < 50) c++ } c").equals("50");
+		code_v1("var s = 0.5 for (var i = 0; i < 100; i++) { s = s + 0.25 } s").equals("25.5");
+		// The speculation fails on the last element: generic operator
+		code_v1("var c = 0 var a = [] for (var i = 0; i < 99; i++) { push(a, i) } push(a, 'x') for (var i = 0; i < 100; i++) { if (a[i] == 'x') c++ } c").equals("1");
+	}
+
 	/*
 	 * Random operators
 	 */
@@ -158,4 +158,7 @@ void Test::test_set() {
 
 	section("Set clone()");
 	code("let s = <1, 2, 3> [s]").equals("[<1, 2, 3>]");
+
+	section("Small sets in a loop");
+	code("var c = 0 for (var i = 0; i < 1000; i++) { var s = <i, i + 1, i> c += s.size() } c").equals("2000");
 }
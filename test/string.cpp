@@ -143,6 +143,19 @@ void Test::test_strings() {
 	code("let a = [for c in 'salut' { (c.code() + 2).char() }] a.join('')").equals("'ucnwv'");
 	code("var r = '' for k : c in 'azerty' { r += k + '_' + c + '_' } r").equals("'0_a_1_z_2_e_3_r_4_t_5_y_'");
 
+	/*
+	 * Copy-on-write
+	 */
+	section("String copy-on-write");
+	code("var a = 'abc' var b = a b += 'd' [a, b]").cow().equals("['abc', 'abcd']");
+	code("var a = 'abc' var b = a a += 'd' [a, b]").cow().equals("['abcd', 'abc']");
+	code("var a = 'abc' var b = a var c = b c += 'd' b += 'e' [a, b, c]").cow().equals("['abc', 'abce', 'abcd']");
+	code("var a = 'abc' var b = 'x' b = a a += '!' b += '?' [a, b]").cow().equals("['abc!', 'abc?']");
+	code("var a = 'abc' { var b = a } a += 'd' a").cow().equals("'abcd'");
+	code("let f = x -> { x += '+' } var a = 'A' var b = a f(a) [a, b]").cow().equals("['A+', 'A']");
+	code("var a = 'A' var b = a let f = -> { a += '+' } f() [a, b]").cow().equals("['A+', 'A']");
+	code("var a = 'A' var b = a var r = [] for i in [1, 2] { b += i r.push(a + b) } r").cow().equals("['AA1', 'AA12']");
+
 	/*
 	 * String standard library
 	 */
@@ -71,6 +71,21 @@ void Test::test_system() {
 	code("print('hello')").output("hello\n");
 	code("print([1, 2, 3])").output("[1, 2, 3]\n");
 
+	section("Output streams");
+	ls::OutputStringStream bounded { 8 };
+	bounded.stream() << "hello";
+	bounded.end();
+	bounded.stream() << "world";
+	bounded.end();
+	test("Bounded output", bounded.str(), std::string("hello\nwo") + ls::OutputStringStream::TRUNCATED);
+	std::ostringstream json_lines;
+	ls::OutputJsonLines lines { json_lines };
+	lines.stream() << "a \"b\"";
+	lines.end();
+	lines.stream() << 12;
+	lines.end();
+	test("JSON lines output", json_lines.str(), std::string("{\"print\":\"a \\\"b\\\"\"}\n{\"print\":\"12\"}\n"));
+
 	section("v1 debug");
 	code_v1("debug('hello')").output("hello\n");
 }